@@ -1,6 +1,6 @@
 #include "block.hpp"
 #include "sha256_wrapper.hpp"
-#include <simd/simd.h> // For simd::uint2
+#include <simd/simd.h> // For simd::uint3
 
 // Serialize the block header as 80 bytes (little endian, reversed hashes)
 std::vector<uint8_t> BlockHeader::toBytes() const {
@@ -28,6 +28,24 @@ std::vector<uint8_t> BlockHeader::toBytes() const {
     return bytes;
 }
 
+BlockHeader BlockHeader::fromBytes(const uint8_t* bytes) {
+    auto readLE32 = [&](size_t offset) {
+        return uint32_t(bytes[offset]) | (uint32_t(bytes[offset + 1]) << 8) |
+               (uint32_t(bytes[offset + 2]) << 16) | (uint32_t(bytes[offset + 3]) << 24);
+    };
+
+    BlockHeader h;
+    h.version = readLE32(0);
+    for (int i = 0; i < 32; ++i) {
+        h.prevBlockHash[i] = bytes[4 + 31 - i];
+        h.merkleRoot[i] = bytes[36 + 31 - i];
+    }
+    h.timestamp = readLE32(68);
+    h.bits = readLE32(72);
+    h.nonce = readLE32(76);
+    return h;
+}
+
 std::vector<uint32_t> BlockHeader::getMidstateWords() const {
     // Compute SHA256 midstate from first 64 bytes of header
     std::vector<uint8_t> headerBytes = toBytes();
@@ -36,12 +54,12 @@ std::vector<uint32_t> BlockHeader::getMidstateWords() const {
     return sha256_midstate(first64); // Your existing function returning midstate uint32_t vector
 }
 
-simd::uint2 BlockHeader::getTailWords() const {
-    // Extract the last 8 bytes (nonce + bits) for tail words
+simd::uint3 BlockHeader::getTailWords() const {
     std::vector<uint8_t> headerBytes = toBytes();
+    auto readBE32 = [&](size_t offset) {
+        return (uint32_t(headerBytes[offset]) << 24) | (uint32_t(headerBytes[offset + 1]) << 16) |
+               (uint32_t(headerBytes[offset + 2]) << 8) | uint32_t(headerBytes[offset + 3]);
+    };
 
-    uint32_t w1 = *(uint32_t*)(&headerBytes[64]); // nonce bytes
-    uint32_t w2 = *(uint32_t*)(&headerBytes[68]); // bits bytes
-
-    return simd::uint2{w1, w2};
+    return simd::uint3{readBE32(64), readBE32(68), readBE32(72)}; // merkle tail, time, bits
 }
@@ -35,9 +35,13 @@ struct BlockHeader {
 
     std::vector<uint8_t> toBytes() const;
 
+    // Inverse of toBytes() for an 80-byte serialized header
+    static BlockHeader fromBytes(const uint8_t* bytes);
+
     // Returns vector<uint32_t> representing the 8 32-bit words of midstate
     std::vector<uint32_t> getMidstateWords() const;
 
-    // Returns the last 8 bytes (tail words) packed as simd::uint2 (two uint32_t)
-    simd::uint2 getTailWords() const;
+    // Header bytes 64..75 (merkle root tail, time, bits) as the big-endian
+    // words W[0..2] of the second SHA-256 block; the nonce is W[3]
+    simd::uint3 getTailWords() const;
 };
@@ -22,12 +22,15 @@ BASE_LDFLAGS="-L$OPENSSL_LIB_DIR -lssl -lcrypto -framework Foundation -framework
 
 echo "🔧 Compiling shared source files..."
 $CXX    $BASE_CXXFLAGS -c utils.cpp             -o build/utils.o
+$CXX    $BASE_CXXFLAGS -c hex_codec.cpp         -o build/hex_codec.o
 $CXX    $BASE_CXXFLAGS -c rpc.cpp               -o build/rpc.o
 $CXX    $BASE_CXXFLAGS -c sha256_compress.cpp   -o build/sha256_compress.o
 $CXX    $BASE_CXXFLAGS -c sha256_wrapper.cpp    -o build/sha256_wrapper.o       # <<< Added this line
 $CXX    $BASE_CXXFLAGS -c block_utils.cpp       -o build/block_utils.o
 $CXX    $BASE_CXXFLAGS -c midstate.cpp          -o build/midstate.o
 $CXX    $BASE_CXXFLAGS -c block.cpp             -o build/block.o
+$CXX    $BASE_CXXFLAGS -c oracle/nonce_prior.cpp -o build/nonce_prior.o
+$CXX    $BASE_CXXFLAGS -c oracle/midstate_batch.cpp -o build/midstate_batch.o
 
 $OBJCXX $BASE_CXXFLAGS -ObjC++ -c metal_miner.mm -o build/metal_miner.o
 $CXX    $BASE_CXXFLAGS -c metal_ui.cpp          -o build/metal_ui.o
@@ -35,7 +38,7 @@ $OBJCXX $BASE_CXXFLAGS -ObjC++ -c metal_ui.mm   -o build/metal_ui_mm.o
 $CXX    $BASE_CXXFLAGS -c main.cpp              -o build/main.o
 
 echo "🧩 Linking full MetalMiner executable..."
-$OBJCXX build/main.o build/utils.o build/rpc.o build/sha256_compress.o build/sha256_wrapper.o build/block_utils.o build/midstate.o build/block.o \
+$OBJCXX build/main.o build/utils.o build/hex_codec.o build/rpc.o build/sha256_compress.o build/sha256_wrapper.o build/block_utils.o build/midstate.o build/block.o build/nonce_prior.o build/midstate_batch.o \
         build/metal_miner.o build/metal_ui.o build/metal_ui_mm.o \
         $BASE_LDFLAGS -o MetalMiner
 echo "✅ Build complete for MetalMiner."
@@ -13,7 +13,13 @@ CXXFLAGS="-std=c++20 -Wall -Wextra -O2 -isysroot $SDK_PATH $INCLUDE_FLAGS"
 LDFLAGS="-L$OPENSSL_LIB_DIR -lssl -lcrypto"
 
 # Removed sha256_utils.cpp to avoid duplicate symbol 'sha256' linker error
-$CXX $CXXFLAGS test_midstate.cpp sha256_wrapper.cpp sha256_compress.cpp -o test_midstate $LDFLAGS
+$CXX $CXXFLAGS test_midstate.cpp sha256_wrapper.cpp sha256_compress.cpp hex_codec.cpp -o test_midstate $LDFLAGS
 
 echo "✅ test_midstate built."
 ./test_midstate
+
+echo "🔧 Building SIMD regression tests..."
+$CXX $CXXFLAGS -Wno-deprecated-declarations -pthread test_midstate_batch.cpp oracle/midstate_batch.cpp hex_codec.cpp -o test_midstate_batch $LDFLAGS
+$CXX $CXXFLAGS test_hex_codec.cpp hex_codec.cpp -o test_hex_codec
+./test_midstate_batch
+./test_hex_codec
@@ -0,0 +1,85 @@
+#!/bin/bash
+set -e
+
+# Builds the oracle tools into oracle/, where main.cpp runs ./oracle/oracle_dispatcher
+
+echo "🛠️  Cleaning previous oracle build..."
+rm -rf build/oracle
+mkdir -p build/oracle
+
+CXX=${CXX:-clang++}
+INCLUDE_FLAGS="-I. -I./oracle"
+LDFLAGS="-lcrypto -pthread"
+if command -v brew >/dev/null 2>&1; then
+    OPENSSL_PREFIX=$(brew --prefix openssl)
+    INCLUDE_FLAGS="$INCLUDE_FLAGS -I/opt/homebrew/include -I$OPENSSL_PREFIX/include"
+    LDFLAGS="-L$OPENSSL_PREFIX/lib $LDFLAGS"
+fi
+if command -v xcrun >/dev/null 2>&1; then
+    INCLUDE_FLAGS="$INCLUDE_FLAGS -isysroot $(xcrun --sdk macosx --show-sdk-path)"
+fi
+ARCH_FLAGS=${ARCH_FLAGS:--march=native}
+CXXFLAGS="-std=c++20 -O2 $ARCH_FLAGS -Wall -Wextra -Wno-deprecated-declarations -pthread $INCLUDE_FLAGS"
+
+ORACLE_LIB_SOURCES=(
+    hex_codec.cpp
+    oracle/bit_bias.cpp
+    oracle/byte_histogram.cpp
+    oracle/chain_store.cpp
+    oracle/cnn_oracle.cpp
+    oracle/entropy_batch.cpp
+    oracle/hamming_index.cpp
+    oracle/hamming_pairs.cpp
+    oracle/header_index.cpp
+    oracle/header_ingest.cpp
+    oracle/midstate_batch.cpp
+    oracle/midstate_clusters.cpp
+    oracle/midstate_set.cpp
+    oracle/midstate_stream.cpp
+    oracle/nonce_prior.cpp
+    oracle/npy_writer.cpp
+    oracle/oracle_cache.cpp
+    oracle/oracle_state.cpp
+    oracle/oracle_store.cpp
+    oracle/oracle_table.cpp
+    oracle/oracle_weights.cpp
+    oracle/prefix_sketch.cpp
+    oracle/quantile_sketch.cpp
+    oracle/randomness_tests.cpp
+    oracle/sha256_wrapper.cpp
+)
+
+ORACLE_TOOLS=(
+    analyze_bits
+    analyze_midstates
+    avalanche_profile
+    backtest_oracle
+    bench_entropy
+    build_chain_store
+    build_midstates
+    build_nonce_prior
+    cluster_midstates
+    cnn_score
+    export_training
+    fit_weights
+    generate_synthetic
+    header_lookup
+    ingest_headers
+    midstate_knn
+    oracle_builder
+    oracle_dispatcher
+    oracle_update
+    randomness_battery
+)
+
+echo "🔧 Compiling oracle library..."
+for src in "${ORACLE_LIB_SOURCES[@]}"; do
+    $CXX $CXXFLAGS -c "$src" -o "build/oracle/$(basename "${src%.cpp}").o"
+done
+ar rcs build/oracle/liboracle.a build/oracle/*.o
+
+echo "🧩 Linking oracle tools..."
+for tool in "${ORACLE_TOOLS[@]}"; do
+    $CXX $CXXFLAGS "oracle/$tool.cpp" build/oracle/liboracle.a $LDFLAGS -o "oracle/$tool"
+done
+echo "✅ Built ${#ORACLE_TOOLS[@]} oracle tools in oracle/."
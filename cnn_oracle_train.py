@@ -1,43 +1,58 @@
 # cnn_oracle_train.py
-import torch
-import torch.nn as nn
 import json
+import os
 import numpy as np
+import torch
+import torch.nn as nn
 from cnn_oracle_model import CNNOracle
 
-def hex_to_float_vector(midstate_hex, tail_hex):
-    raw_bytes = bytes.fromhex(midstate_hex + tail_hex)
-    return np.frombuffer(raw_bytes, dtype=np.uint8).astype(np.float32) / 255.0
+TRAIN_DIR = "oracle/train"  # written by oracle/export_training
+BATCH_SIZE = 4096
+EPOCHS = 50
+
+def load_shards(train_dir):
+    with open(os.path.join(train_dir, "manifest.json")) as f:
+        manifest = json.load(f)
+
+    shards = []
+    for shard in manifest["shards"]:
+        # Memory-mapped: rows are paged in as batches touch them, nothing is parsed
+        X = np.load(os.path.join(train_dir, shard["features"]), mmap_mode="r")
+        y = np.load(os.path.join(train_dir, shard["labels"]), mmap_mode="r")
+        shards.append((X, y))
+    return manifest, shards
+
+def batches(shards, batch_size, rng):
+    # Shard order and batch order are shuffled; each batch is one contiguous slice
+    for s in rng.permutation(len(shards)):
+        X, y = shards[s]
+        for start in rng.permutation(np.arange(0, len(y), batch_size)):
+            xb = np.asarray(X[start:start + batch_size], dtype=np.float32)
+            if X.dtype == np.uint8:
+                xb /= 255.0
+            yb = np.asarray(y[start:start + batch_size], dtype=np.float32)
+            yield torch.from_numpy(xb).unsqueeze(1), torch.from_numpy(yb).unsqueeze(1)
 
 def main():
-    with open("oracle/top_midstates.json") as f:
-        data = json.load(f)
-
-    X, y = [], []
-    for entry in data:
-        vec = hex_to_float_vector(entry["midstate"], entry["tail"])
-        X.append(vec)
-        y.append(entry["score"])
+    manifest, shards = load_shards(TRAIN_DIR)
+    print("Rows:", manifest["rows"], "in", len(shards), "shards")
 
-    X = np.stack(X)
-    y = np.array(y).astype(np.float32)
-
-    print("X shape:", X.shape)
-
-    X_tensor = torch.tensor(X).unsqueeze(1)
-    y_tensor = torch.tensor(y).unsqueeze(1)
-
-    model = CNNOracle(input_length=X.shape[2])
+    model = CNNOracle(input_length=manifest["input_length"])
     optimizer = torch.optim.Adam(model.parameters(), lr=1e-3)
     loss_fn = nn.MSELoss()
-
-    for epoch in range(50):
-        pred = model(X_tensor)
-        loss = loss_fn(pred, y_tensor)
-        optimizer.zero_grad()
-        loss.backward()
-        optimizer.step()
-        print(f"Epoch {epoch+1}, Loss: {loss.item():.6f}")
+    rng = np.random.default_rng(0)
+
+    for epoch in range(EPOCHS):
+        total, rows = 0.0, 0
+        for X_tensor, y_tensor in batches(shards, BATCH_SIZE, rng):
+            pred = model(X_tensor)
+            loss = loss_fn(pred, y_tensor)
+            optimizer.zero_grad()
+            loss.backward()
+            optimizer.step()
+            total += loss.item() * len(y_tensor)
+            rows += len(y_tensor)
+        print(f"Epoch {epoch+1}, Loss: {total / max(rows, 1):.6f}")
 
     torch.save(model.state_dict(), "cnn_oracle.pth")
 
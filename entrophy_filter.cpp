@@ -1,4 +1,7 @@
 #include "entropy_metrics.hpp"
+#include "sha256_utils.hpp"
+#include "oracle/byte_histogram.hpp"
+#include "oracle/entropy_tables.hpp"
 #include <cstring>
 #include <cmath>
 #include <iostream>
@@ -6,7 +9,15 @@
 // Hamming distance implementation
 int hammingDistance(const uint8_t* a, const uint8_t* b, size_t length) {
     int dist = 0;
-    for (size_t i = 0; i < length; i++) {
+    size_t i = 0;
+    // 64 bits per popcount, then the leftover bytes
+    for (; i + 8 <= length; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        dist += __builtin_popcountll(x ^ y);
+    }
+    for (; i < length; i++) {
         uint8_t val = a[i] ^ b[i];
         dist += __builtin_popcount(val);
     }
@@ -15,6 +26,11 @@ int hammingDistance(const uint8_t* a, const uint8_t* b, size_t length) {
 
 // Shannon entropy implementation
 double shannonEntropy(const uint8_t* data, size_t length) {
+    // Midstate and midstate + tail records use the compile-time tables
+    if (length == entropy::kMidstateRecordBytes) return entropy::byte_entropy<entropy::kMidstateRecordBytes>(data);
+    if (length == entropy::kTailRecordBytes) return entropy::byte_entropy<entropy::kTailRecordBytes>(data);
+    // Large buffers use the multi-table histogram kernel
+    if (length >= 4096) return entropy::buffer_entropy(data, length);
     int counts[256] = {0};
     for (size_t i = 0; i < length; i++) {
         counts[data[i]]++;
@@ -35,15 +51,21 @@ double entropySlope(const std::vector<uint8_t>& prev, const std::vector<uint8_t>
     return currEntropy - prevEntropy;
 }
 
-// Bit flip sensitivity - count how many bits differ when flipping each bit in input one at a time
+// Bit flip sensitivity - average number of double SHA-256 output bits that
+// change when each input bit is flipped in turn (128 for an ideal hash).
+// Batched 80-byte header profiles live in oracle/midstate_batch.hpp.
 int bitFlipSensitivity(const uint8_t* input, size_t length) {
-    // Placeholder - real implementation would require hashing output difference
-    // Here, simply return the number of bits set in input as a demo
-    int sensitivity = 0;
-    for (size_t i = 0; i < length; i++) {
-        sensitivity += __builtin_popcount(input[i]);
+    if (length == 0) return 0;
+    std::vector<uint8_t> data(input, input + length);
+    const std::vector<uint8_t> base = sha256Double(data);
+
+    long long changed = 0;
+    for (size_t bit = 0; bit < length * 8; ++bit) {
+        data[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+        changed += hammingDistance(sha256Double(data).data(), base.data(), base.size());
+        data[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
     }
-    return sensitivity;
+    return static_cast<int>((changed + length * 4) / (length * 8));
 }
 
 
@@ -0,0 +1,41 @@
+import struct
+import torch
+from cnn_oracle_model import CNNOracle
+
+INPUT_LENGTH = 48  # midstate (32 bytes) + tail (16 bytes)
+WEIGHTS_PATH = "oracle/cnn_oracle.bin"
+CHECK_PATH = "oracle/cnn_oracle_check.bin"
+CHECK_SAMPLES = 256
+
+# 1. Load the PyTorch model
+model = CNNOracle(input_length=INPUT_LENGTH)
+model.load_state_dict(torch.load("cnn_oracle.pth"))
+model.eval()
+
+conv1, conv2, fc1, fc2 = model.net[0], model.net[2], model.net[5], model.net[7]
+
+
+def f32(t):
+    return t.detach().cpu().contiguous().numpy().astype("<f4").tobytes()
+
+
+# 2. Flat weights for the C++ engine (oracle/cnn_oracle.cpp): header, then
+#    float32 weight/bias of each layer in PyTorch layout
+with open(WEIGHTS_PATH, "wb") as f:
+    f.write(b"CNNORCL1")
+    f.write(struct.pack("<6I", 1, INPUT_LENGTH, conv1.out_channels, conv2.out_channels,
+                        fc1.out_features, conv1.kernel_size[0]))
+    for layer in (conv1, conv2, fc1, fc2):
+        f.write(f32(layer.weight))
+        f.write(f32(layer.bias))
+
+# 3. Reference predictions, for `cnn_score --check`
+x = torch.randint(0, 256, (CHECK_SAMPLES, 1, INPUT_LENGTH)).float() / 255.0
+with torch.no_grad():
+    y = model(x)
+with open(CHECK_PATH, "wb") as f:
+    f.write(struct.pack("<2I", CHECK_SAMPLES, INPUT_LENGTH))
+    f.write(f32(x))
+    f.write(f32(y))
+
+print(f"✅ Exported {WEIGHTS_PATH} and {CHECK_PATH}")
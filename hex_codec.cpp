@@ -0,0 +1,199 @@
+#include "hex_codec.hpp"
+#include <array>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// ASCII -> nibble, 0xFF for anything that is not a hex digit
+constexpr std::array<uint8_t, 256> kNibble = [] {
+    std::array<uint8_t, 256> t{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= '0' && c <= '9') t[c] = static_cast<uint8_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') t[c] = static_cast<uint8_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') t[c] = static_cast<uint8_t>(c - 'A' + 10);
+        else t[c] = 0xFF;
+    }
+    return t;
+}();
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+// Decodes n bytes with the lookup table; false on a non-hex character
+bool decodeScalar(const char* hex, size_t n, uint8_t* out) {
+    uint8_t bad = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t hi = kNibble[static_cast<uint8_t>(hex[2 * i])];
+        uint8_t lo = kNibble[static_cast<uint8_t>(hex[2 * i + 1])];
+        bad |= hi | lo;
+        out[i] = static_cast<uint8_t>((hi << 4) | (lo & 0x0F));
+    }
+    return (bad & 0xF0) == 0;
+}
+
+void encodeScalar(const uint8_t* data, size_t n, char* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = kDigits[data[i] >> 4];
+        out[2 * i + 1] = kDigits[data[i] & 0x0F];
+    }
+}
+
+#if defined(__AVX2__)
+
+// Nibble values of 32 hex characters; ok is cleared if any is not a hex digit
+inline __m256i nibbles(__m256i c, __m256i& ok) {
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isAlpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    ok = _mm256_and_si256(ok, _mm256_or_si256(isDigit, isAlpha));
+    __m256i letter = _mm256_add_epi8(alpha, _mm256_set1_epi8(10));
+    return _mm256_blendv_epi8(letter, digit, isDigit);
+}
+
+// 32 characters -> 16 bytes per step
+size_t decodeVector(const char* hex, size_t n, uint8_t* out, bool& valid) {
+    __m256i ok = _mm256_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = nibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + 2 * i)), ok);
+        // Each 16-bit lane holds (first, second) nibbles; merge to first << 4 | second
+        __m256i merged = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0x00FF)), 4),
+                                         _mm256_srli_epi16(v, 8));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(merged, merged), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_castsi256_si128(packed));
+    }
+    valid = _mm256_movemask_epi8(ok) == -1;
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+inline __m128i nibbles(__m128i c, __m128i& ok) {
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    ok = _mm_and_si128(ok, _mm_or_si128(isDigit, isAlpha));
+    __m128i letter = _mm_add_epi8(alpha, _mm_set1_epi8(10));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_andnot_si128(isDigit, letter));
+}
+
+// 32 characters -> 16 bytes per step
+size_t decodeVector(const char* hex, size_t n, uint8_t* out, bool& valid) {
+    __m128i ok = _mm_set1_epi8(-1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i packed[2];
+        for (int k = 0; k < 2; ++k) {
+            __m128i v = nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 2 * i + 16 * k)), ok);
+            packed[k] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00FF)), 4),
+                                     _mm_srli_epi16(v, 8));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(packed[0], packed[1]));
+    }
+    valid = _mm_movemask_epi8(ok) == 0xFFFF;
+    return i;
+}
+
+#elif defined(__ARM_NEON)
+
+inline uint8x16_t nibbles(uint8x16_t c, uint8x16_t& ok) {
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(9));
+    uint8x16_t isAlpha = vcleq_u8(alpha, vdupq_n_u8(5));
+    ok = vandq_u8(ok, vorrq_u8(isDigit, isAlpha));
+    return vbslq_u8(isDigit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+}
+
+// 32 characters -> 16 bytes per step; vld2q splits high and low characters
+size_t decodeVector(const char* hex, size_t n, uint8_t* out, bool& valid) {
+    uint8x16_t ok = vdupq_n_u8(0xFF);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x2_t c = vld2q_u8(reinterpret_cast<const uint8_t*>(hex + 2 * i));
+        uint8x16_t hi = nibbles(c.val[0], ok);
+        uint8x16_t lo = nibbles(c.val[1], ok);
+        vst1q_u8(out + i, vsliq_n_u8(lo, hi, 4));
+    }
+    valid = vminvq_u8(ok) == 0xFF;
+    return i;
+}
+
+#else
+
+size_t decodeVector(const char*, size_t, uint8_t*, bool& valid) {
+    valid = true;
+    return 0;
+}
+
+#endif
+
+#if defined(__SSE2__)
+
+// 16 bytes -> 32 characters per step
+size_t encodeVector(const uint8_t* data, size_t n, char* out) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i lo = _mm_and_si128(v, mask);
+        __m128i first = _mm_unpacklo_epi8(hi, lo);
+        __m128i second = _mm_unpackhi_epi8(hi, lo);
+        // '0' + n, plus 'a' - '0' - 10 for n > 9
+        for (__m128i* part : {&first, &second}) {
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(*part, _mm_set1_epi8(9)), _mm_set1_epi8(39));
+            *part = _mm_add_epi8(_mm_add_epi8(*part, _mm_set1_epi8('0')), letter);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), first);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), second);
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON)
+
+// 16 bytes -> 32 characters per step; vst2q interleaves high and low digits
+size_t encodeVector(const uint8_t* data, size_t n, char* out) {
+    const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(kDigits));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(data + i);
+        uint8x16x2_t pair;
+        pair.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+        pair.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0F)));
+        vst2q_u8(reinterpret_cast<uint8_t*>(out + 2 * i), pair);
+    }
+    return i;
+}
+
+#else
+
+size_t encodeVector(const uint8_t*, size_t, char*) {
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+bool hexDecode(std::string_view hex, uint8_t* out) {
+    if (hex.size() % 2 != 0) return false;
+    size_t n = hex.size() / 2;
+    bool valid = true;
+    size_t done = decodeVector(hex.data(), n, out, valid);
+    return decodeScalar(hex.data() + 2 * done, n - done, out + done) && valid;
+}
+
+void hexEncode(const uint8_t* data, size_t n, char* out) {
+    size_t done = encodeVector(data, n, out);
+    encodeScalar(data + done, n - done, out + 2 * done);
+}
@@ -0,0 +1,23 @@
+// hex_codec.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Shared hex codec. Decoding and encoding work on caller-provided buffers and
+// use 32/16-byte vector paths (AVX2 or SSE2 on x86, NEON on arm64) with a
+// lookup-table scalar path for the remainder.
+
+// Decodes hex.size() / 2 bytes into out. Accepts upper and lower case.
+// Returns false on odd length or a non-hex character; out is then unspecified.
+bool hexDecode(std::string_view hex, uint8_t* out);
+
+// Writes 2 * n lowercase hex characters to out (no terminator)
+void hexEncode(const uint8_t* data, size_t n, char* out);
+
+inline std::string hexEncode(const uint8_t* data, size_t n) {
+    std::string s(2 * n, '0');
+    hexEncode(data, n, s.data());
+    return s;
+}
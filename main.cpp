@@ -4,6 +4,8 @@
 #include "metal_ui.hpp"
 #include "rpc.hpp"
 #include "coinbase.hpp"
+#include "oracle/nonce_prior.hpp"
+#include "oracle/midstate_batch.hpp"
 
 #include <iostream>
 #include <vector>
@@ -21,7 +23,8 @@
 bool metalMineBlock(
     const BlockHeader& header,
     const std::vector<uint8_t>& target,
-    uint32_t initialNonceBase,
+    uint32_t nonceBase,
+    uint64_t maxNonces,
     uint32_t& validIndex,
     std::vector<uint8_t>& validHash,
     std::vector<uint8_t>& sampleHashOut,
@@ -156,6 +159,15 @@ int main() {
         logLine("🎯 Target (difficulty bits): " + toHex(header.bits));
         logLine("⚙️ Starting GPU mining...");
 
+        // Sweep dense nonce ranges from oracle/nonce_prior.json first; sequential without it
+        NonceSchedule nonceSchedule;
+        NoncePrior noncePrior;
+        if (loadNoncePrior("oracle/nonce_prior.json", noncePrior)) {
+            nonceSchedule = NonceSchedule(noncePrior);
+            logLine("🧭 Nonce sweep ordered by oracle/nonce_prior.json (" + std::to_string(noncePrior.headers) + " headers)");
+        }
+        uint64_t sweepPosition = 0;
+
         stats.nonceBase = 0;
         stats.totalHashes = 0;
         stats.startTime.store(std::chrono::steady_clock::now());
@@ -170,15 +182,25 @@ int main() {
             std::vector<uint8_t> sampleHash(32, 0);
             uint64_t hashesTried = 0;
 
+            if (sweepPosition >= (uint64_t(1) << 32)) {
+                logLine("🔁 Swept the whole nonce space, starting over");
+                sweepPosition = 0;
+            }
+            stats.nonceBase = nonceSchedule.nonceAt(sweepPosition);
+
+            // A batch stops at the end of its schedule bin, so the kernel's contiguous
+            // range never runs into a bin the schedule visits at another time
+            uint64_t batchLimit = nonceSchedule.runLength(sweepPosition);
+
             auto batchStart = std::chrono::steady_clock::now();
-            bool found = metalMineBlock(header, target, stats.nonceBase.load(), validIndex, validHash, sampleHash, hashesTried);
+            bool found = metalMineBlock(header, target, stats.nonceBase.load(), batchLimit, validIndex, validHash, sampleHash, hashesTried);
             auto batchEnd = std::chrono::steady_clock::now();
 
             stats.totalHashes.fetch_add(hashesTried);
             double seconds = std::chrono::duration<double>(batchEnd - batchStart).count();
             if (seconds > 0)
                 stats.hashrate.store(static_cast<float>(hashesTried) / seconds);
-            stats.nonceBase.fetch_add(static_cast<uint32_t>(hashesTried));
+            sweepPosition += hashesTried;
 
             {
                 std::lock_guard<std::mutex> lock(stats.mutex);
@@ -187,12 +209,30 @@ int main() {
                 stats.sampleHashStr = bytesToHex(sampleHash);
                 std::copy_n(sampleHash.begin(), std::min(sampleHash.size(), stats.sampleHash.size()), stats.sampleHash.begin());
 
+                // Recompute the kernel's hit on the host; a mismatch means the kernel
+                // hashed something other than this header, so nothing is submitted
+                if (!validHash.empty()) {
+                    BlockHeader solved = header;
+                    solved.nonce = validIndex;
+                    std::vector<uint8_t> solvedBytes = solved.toBytes();
+                    Header80 solvedHeader;
+                    std::copy(solvedBytes.begin(), solvedBytes.end(), solvedHeader.bytes);
+                    Hash256 digest;
+                    hashHeader(solvedHeader, digest);
+                    std::vector<uint8_t> hostHash(digest.rbegin(), digest.rend());
+                    if (hostHash != validHash || hostHash > target) {
+                        logLine("❌ Kernel hit at nonce " + std::to_string(validIndex) + " fails the host check: kernel " +
+                                bytesToHex(validHash) + ", host " + bytesToHex(hostHash));
+                        validHash.clear();
+                    }
+                }
+
                 if (!validHash.empty()) {
                     stats.validNonce = validIndex;
                     stats.validHashStr = bytesToHex(validHash);
                     stats.found.store(true);
 
-                    logLine("✅ Valid hash found at midstate index: " + std::to_string(validIndex));
+                    logLine("✅ Valid hash found at nonce: " + std::to_string(validIndex));
                     std::string fullBlockHex = createFullBlockHex(header, validIndex, "", nlohmann::json::array());
                     submitBlockRpc(rpc, fullBlockHex);
                     break;
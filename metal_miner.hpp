@@ -10,7 +10,8 @@ using ByteVector = std::vector<uint8_t>;
 bool metalMineBlock(
     const BlockHeader& header,
     const std::vector<uint8_t>& target,
-    uint32_t initialNonceBase,
+    uint32_t nonceBase,
+    uint64_t maxNonces,
     uint32_t& validIndex,
     std::vector<uint8_t>& validHash,
     std::vector<uint8_t>& sampleHashOut,
@@ -48,7 +48,7 @@ public:
         commandQueue = [device newCommandQueue];
 
         midstateBuffer = [device newBufferWithLength:THREADS_PER_GRID * 8 * sizeof(uint32_t) options:MTLResourceStorageModeShared];
-        tailWordBuffer = [device newBufferWithLength:THREADS_PER_GRID * sizeof(simd::uint2) options:MTLResourceStorageModeShared];
+        tailWordBuffer = [device newBufferWithLength:THREADS_PER_GRID * sizeof(simd::uint3) options:MTLResourceStorageModeShared];
         targetBuffer = [device newBufferWithLength:32 options:MTLResourceStorageModeShared];
         resultNonceBuffer = [device newBufferWithLength:sizeof(uint32_t) options:MTLResourceStorageModeShared];
         resultHashBuffer = [device newBufferWithLength:THREADS_PER_GRID * HASHES_PER_THREAD * 32 options:MTLResourceStorageModeShared];
@@ -69,15 +69,17 @@ public:
         memcpy(midstateBuffer.contents, midstates.data(), midstates.size() * sizeof(uint32_t));
     }
 
-    void setTailWords(const std::vector<simd::uint2>& tailWords) {
-        memcpy(tailWordBuffer.contents, tailWords.data(), tailWords.size() * sizeof(simd::uint2));
+    void setTailWords(const std::vector<simd::uint3>& tailWords) {
+        memcpy(tailWordBuffer.contents, tailWords.data(), tailWords.size() * sizeof(simd::uint3));
     }
 
     void setTarget(const std::vector<uint8_t>& target) {
         memcpy(targetBuffer.contents, target.data(), 32);
     }
 
-    bool mine(uint32_t& foundNonce, std::vector<uint8_t>& foundHash, uint64_t& hashesTried, std::vector<uint8_t>& sampleHashOut) {
+    // Tries nonces nonceBase .. nonceBase + nonceCount - 1, nonceCount at most one grid's worth
+    bool mine(uint32_t nonceBase, uint32_t nonceCount, uint32_t& foundNonce, std::vector<uint8_t>& foundHash,
+              uint64_t& hashesTried, std::vector<uint8_t>& sampleHashOut) {
         reset();
 
         id<MTLCommandBuffer> commandBuffer = [commandQueue commandBuffer];
@@ -91,9 +93,12 @@ public:
         [encoder setBuffer:resultHashBuffer offset:0 atIndex:4];
         [encoder setBuffer:sampleHashLockBuffer offset:0 atIndex:5];
         [encoder setBuffer:sampleHashBuffer offset:0 atIndex:6];
+        [encoder setBytes:&nonceBase length:sizeof(nonceBase) atIndex:7];
+        [encoder setBytes:&nonceCount length:sizeof(nonceCount) atIndex:8];
 
-        NSUInteger tgSize = std::min((NSUInteger)THREADS_PER_GRID, pipelineState.maxTotalThreadsPerThreadgroup);
-        NSUInteger numGroups = (THREADS_PER_GRID + tgSize - 1) / tgSize;
+        NSUInteger threads = (nonceCount + HASHES_PER_THREAD - 1) / HASHES_PER_THREAD;
+        NSUInteger tgSize = std::min(threads, pipelineState.maxTotalThreadsPerThreadgroup);
+        NSUInteger numGroups = (threads + tgSize - 1) / tgSize;
 
         [encoder dispatchThreads:MTLSizeMake(numGroups * tgSize, 1, 1)
          threadsPerThreadgroup:MTLSizeMake(tgSize, 1, 1)];
@@ -101,24 +106,24 @@ public:
         [commandBuffer commit];
         [commandBuffer waitUntilCompleted];
 
-        hashesTried = THREADS_PER_GRID * HASHES_PER_THREAD;
+        hashesTried = nonceCount;
         uint32_t nonceValue = *(uint32_t*)resultNonceBuffer.contents;
-        foundNonce = nonceValue;
 
         [sampleHashBuffer didModifyRange:NSMakeRange(0, 32)];
         uint8_t* samplePtr = (uint8_t*)sampleHashBuffer.contents;
         sampleHashOut.assign(samplePtr, samplePtr + 32);
 
+        // The kernel stores the batch offset + 1, so 0 means nothing was found
         if (nonceValue == 0) return false;
-        uint32_t index = nonceValue / HASHES_PER_THREAD;
-        uint32_t offset = nonceValue % HASHES_PER_THREAD;
+        uint32_t index = nonceValue - 1;
 
-        if (index >= THREADS_PER_GRID) {
+        if (index >= nonceCount) {
             logLine("⚠️ Found nonce index out of bounds.");
             return false;
         }
 
-        uint8_t* hashPtr = (uint8_t*)resultHashBuffer.contents + (index * HASHES_PER_THREAD + offset) * 32;
+        foundNonce = nonceBase + index;
+        uint8_t* hashPtr = (uint8_t*)resultHashBuffer.contents + index * 32;
         foundHash.assign(hashPtr, hashPtr + 32);
         return true;
     }
@@ -129,7 +134,8 @@ public:
 bool metalMineBlock(
     const BlockHeader& header,
     const std::vector<uint8_t>& target,
-    uint32_t initialNonceBase,
+    uint32_t nonceBase,
+    uint64_t maxNonces,
     uint32_t& validIndex,
     std::vector<uint8_t>& validHash,
     std::vector<uint8_t>& sampleHashOut,
@@ -156,10 +162,10 @@ bool metalMineBlock(
     }
 
     std::vector<uint32_t> midstate = header.getMidstateWords();
-    simd::uint2 tail = header.getTailWords();
+    simd::uint3 tail = header.getTailWords();
 
     std::vector<uint32_t> mids(THREADS_PER_GRID * 8);
-    std::vector<simd::uint2> tails(THREADS_PER_GRID);
+    std::vector<simd::uint3> tails(THREADS_PER_GRID);
 
     for (size_t i = 0; i < THREADS_PER_GRID; ++i) {
         std::copy(midstate.begin(), midstate.end(), mids.begin() + i * 8);
@@ -169,5 +175,9 @@ bool metalMineBlock(
     miner->setMidstates(mids);
     miner->setTailWords(tails);
     miner->setTarget(target);
-    return miner->mine(validIndex, validHash, totalHashesTried, sampleHashOut);
+
+    // One dispatch covers at most a grid's worth of nonces and never wraps past 2^32
+    uint64_t nonceCount = std::min<uint64_t>({maxNonces, THREADS_PER_GRID * HASHES_PER_THREAD,
+                                              (uint64_t(1) << 32) - nonceBase});
+    return miner->mine(nonceBase, static_cast<uint32_t>(nonceCount), validIndex, validHash, totalHashesTried, sampleHashOut);
 }
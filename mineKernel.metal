@@ -12,47 +12,60 @@ constant uint K[64] = {
     0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
 };
 
+// Nonces each thread tries; must match HASHES_PER_THREAD in metal_miner.mm
+constant uint HASHES_PER_THREAD = 80;
+
 inline uint rotr(uint x, uint n) {
     return (x >> n) | (x << (32 - n));
 }
 
+inline uint bswap(uint x) {
+    return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+}
+
 kernel void mineKernel(
     device const uint* midstates         [[buffer(0)]],
-    device const uint2* tailWords        [[buffer(1)]],
+    device const uint3* tailWords        [[buffer(1)]],
     device const uchar* target           [[buffer(2)]],
     device atomic_uint* resultNonce      [[buffer(3)]],
     device uchar* resultHashes           [[buffer(4)]],
     device atomic_uint* sampleHashLock   [[buffer(5)]],
     device uchar* sampleHashBuffer       [[buffer(6)]],
+    constant uint& nonceBase             [[buffer(7)]],
+    constant uint& nonceCount            [[buffer(8)]],
     uint gid                             [[thread_position_in_grid]]) {
 
+    // Threads past the batch (the grid is rounded up to whole threadgroups) have nothing to do
+    if (gid * HASHES_PER_THREAD >= nonceCount) return;
+
     // Load midstate for this thread
-    uint h[8];
+    uint midstate[8];
     for (uint i = 0; i < 8; ++i)
-        h[i] = midstates[gid * 8 + i];
-
-    // Prepare message schedule W with nonce incrementing:
-    // Use tailWords[gid] for base data,
-    // then encode thread-specific nonce in W[2] and W[3] for uniqueness per hash attempt.
+        midstate[i] = midstates[gid * 8 + i];
 
+    // Second block of the 80-byte header: bytes 64..75 (merkle tail, time,
+    // bits), the nonce, then padding and the 640-bit message length. Only the
+    // nonce word changes between attempts.
     uint W[64];
 
     W[0] = tailWords[gid].x;
     W[1] = tailWords[gid].y;
+    W[2] = tailWords[gid].z;
+    W[4] = 0x80000000;
+    for (uint i = 5; i < 15; ++i) W[i] = 0;
+    W[15] = 640;
 
-    // Introduce nonce increment — base nonce from gid, plus inner thread nonce (0 and 1)
-    // We perform HASHES_PER_THREAD attempts per thread, here 2 attempts
-
-    // For simplicity, only 1 attempt per kernel dispatch; in practice you could loop here for more
-    uint nonceBase = gid * 2; // base nonce for this thread
-    for (uint attempt = 0; attempt < 2; attempt++) {
+    // The batch covers nonces nonceBase .. nonceBase + nonceCount - 1, which the
+    // host keeps inside one range of its sweep; each thread takes HASHES_PER_THREAD of them
+    for (uint attempt = 0; attempt < HASHES_PER_THREAD; attempt++) {
+        uint index = gid * HASHES_PER_THREAD + attempt; // offset of this nonce in the batch
+        if (index >= nonceCount) break;
 
-        W[2] = nonceBase + attempt; // Nonce low word
-        W[3] = 0;                  // Nonce high word or zero if 32-bit nonce
+        uint h[8];
+        for (uint i = 0; i < 8; ++i) h[i] = midstate[i];
 
-        W[4] = 0x80000000;
-        for (uint i = 5; i < 15; ++i) W[i] = 0;
-        W[15] = 80; // Message length: 80 bytes (typical for Bitcoin block header)
+        // The header stores the nonce little-endian; SHA-256 reads words big-endian
+        W[3] = bswap(nonceBase + index);
 
         // Message schedule expansion
         for (uint i = 16; i < 64; ++i) {
@@ -108,12 +121,13 @@ kernel void mineKernel(
         for (uint i = 0; i < 8; ++i)
             H[i] += (i==0)?a:(i==1)?b:(i==2)?c:(i==3)?d:(i==4)?e:(i==5)?f:(i==6)?g:hh;
 
+        // Display order (digest bytes reversed), most significant byte first like the target
         uchar out[32];
         for (uint i = 0; i < 8; ++i) {
-            out[i*4+0] = (H[i] >> 24) & 0xff;
-            out[i*4+1] = (H[i] >> 16) & 0xff;
-            out[i*4+2] = (H[i] >>  8) & 0xff;
-            out[i*4+3] = (H[i] >>  0) & 0xff;
+            out[31 - (i*4+0)] = (H[i] >> 24) & 0xff;
+            out[31 - (i*4+1)] = (H[i] >> 16) & 0xff;
+            out[31 - (i*4+2)] = (H[i] >>  8) & 0xff;
+            out[31 - (i*4+3)] = (H[i] >>  0) & 0xff;
         }
 
         // Compare against target
@@ -138,12 +152,12 @@ kernel void mineKernel(
             atomic_store_explicit(sampleHashLock, 0, memory_order_relaxed);
         }
 
-        // If valid, write nonce and hash results
+        // If valid, write the batch offset + 1 (0 means none found) and the hash
         if (valid) {
             uint expectedNonce = 0;
-            if (atomic_compare_exchange_weak_explicit(resultNonce, &expectedNonce, gid * 2 + attempt, memory_order_relaxed, memory_order_relaxed)) {
+            if (atomic_compare_exchange_weak_explicit(resultNonce, &expectedNonce, index + 1, memory_order_relaxed, memory_order_relaxed)) {
                 for (int i = 0; i < 32; ++i)
-                    resultHashes[(gid * 2 + attempt) * 32 + i] = out[i];
+                    resultHashes[index * 32 + i] = out[i];
             }
         }
     }
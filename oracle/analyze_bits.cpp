@@ -0,0 +1,138 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include "bit_bias.hpp"
+#include "oracle_store.hpp"
+#include "parallel.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+
+// Per-bit-position bias over every midstate, header tail and block hash in the store:
+//
+//   analyze_bits [--store oracle/midstates.bin] [--out oracle/bit_bias.json] [--all] [--top 10]
+//
+// Synthetic rows are skipped unless --all is given (they have no block hash).
+// Each position gets its one-frequency bias and a z-score against a fair
+// coin; the sum of squared z-scores per field is chi-square with one degree
+// of freedom per bit. Tail bits cover time, nBits and nonce, which are
+// structured and expected to show bias; midstate and hash bits should not.
+
+struct Field {
+    const char* name;
+    size_t firstBit;
+    size_t bits;
+};
+
+// The first 80 bytes of a StoreRecord: midstate, tail, blockhash
+constexpr size_t kPayloadBytes = 80;
+static_assert(offsetof(StoreRecord, blockhash) + 32 == kPayloadBytes, "payload must be the record prefix");
+
+constexpr Field kFields[] = {
+    {"midstate", 0, 256},
+    {"tail", 256, 128},
+    {"blockhash", 384, 256},
+};
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string outPath = "oracle/bit_bias.json";
+    bool includeSynthetic = false;
+    size_t top = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--all") includeSynthetic = true;
+        else if (arg == "--store" && i + 1 < argc) storePath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--top" && i + 1 < argc) top = std::stoul(argv[++i]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    // One counter per thread chunk; rows are counted in place in runs of real rows
+    auto start = std::chrono::steady_clock::now();
+    BitPositionCounter total(kPayloadBytes);
+    std::mutex totalMutex;
+    parallelFor(store.size(), [&](size_t begin, size_t end) {
+        BitPositionCounter counter(kPayloadBytes);
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(store.data());
+        size_t run = begin;
+        for (size_t i = begin; i <= end; ++i) {
+            bool keep = i < end && (includeSynthetic || !(store[i].flags & kStoreSynthetic));
+            if (keep) continue;
+            counter.add(base + run * sizeof(StoreRecord), sizeof(StoreRecord), i - run);
+            run = i + 1;
+        }
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total.merge(counter);
+    }, 1 << 16);
+    double ms = msSince(start);
+
+    const uint64_t rows = total.rows();
+    if (rows == 0) {
+        std::cerr << "❌ Error: no rows to analyze in " << storePath << "\n";
+        return 1;
+    }
+    std::cout << "🔬 " << rows << " rows x " << total.bits() << " bits [" << ms << " ms, "
+              << store.size() * sizeof(StoreRecord) / (ms * 1e6) << " GB/s]\n";
+
+    std::vector<uint64_t> counts = total.counts();
+    json out = {{"rows", rows}, {"fields", json::object()}};
+    struct Outlier {
+        const Field* field;
+        size_t bit;
+        BitBias b;
+    };
+    std::vector<Outlier> outliers;
+
+    for (const Field& field : kFields) {
+        json positions = json::array();
+        double chi2 = 0.0;
+        for (size_t bit = 0; bit < field.bits; ++bit) {
+            uint64_t ones = counts[field.firstBit + bit];
+            BitBias b = bitBias(ones, rows);
+            chi2 += b.z * b.z;
+            positions.push_back({{"bit", bit}, {"ones", ones}, {"bias", b.bias}, {"z", b.z}});
+            outliers.push_back({&field, bit, b});
+        }
+        // Wilson-Hilferty: chi-square with k dof to an approximate standard normal
+        double k = static_cast<double>(field.bits);
+        double chi2z = (std::cbrt(chi2 / k) - (1.0 - 2.0 / (9.0 * k))) / std::sqrt(2.0 / (9.0 * k));
+        out["fields"][field.name] = {{"chi2", chi2}, {"dof", field.bits}, {"chi2_z", chi2z}, {"positions", positions}};
+        std::cout << "📊 " << field.name << ": chi² " << chi2 << " over " << field.bits << " bits (z " << chi2z << ")\n";
+    }
+
+    top = std::min(top, outliers.size());
+    std::partial_sort(outliers.begin(), outliers.begin() + top, outliers.end(), [](const Outlier& a, const Outlier& b) {
+        return std::fabs(a.b.z) > std::fabs(b.b.z);
+    });
+    for (size_t i = 0; i < top; ++i) {
+        const Outlier& o = outliers[i];
+        std::cout << "   " << o.field->name << "[" << o.bit << "] bias " << o.b.bias << " z " << o.b.z << "\n";
+    }
+
+    std::ofstream file(outPath);
+    file << out.dump(2);
+    if (!file) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "✅ Saved bit bias to " << outPath << "\n";
+    return 0;
+}
@@ -1,22 +1,13 @@
 #include <iostream>
 #include <fstream>
-#include <unordered_set>
 #include <vector>
 #include <string>
 #include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "midstate_set.hpp"
 
 using json = nlohmann::json;
 
-std::vector<uint8_t> hex_to_bytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        std::string byteString = hex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(strtol(byteString.c_str(), nullptr, 16));
-        bytes.push_back(byte);
-    }
-    return bytes;
-}
-
 int main() {
     std::ifstream inFile("oracle/midstates.json");
     if (!inFile) {
@@ -27,7 +18,7 @@ int main() {
     json midstates_json;
     inFile >> midstates_json;
 
-    std::unordered_set<std::string> unique_midstates;
+    MidstateSet unique_midstates(midstates_json.size());
 
     int count = 0;
     for (const auto& entry : midstates_json) {
@@ -35,8 +26,13 @@ int main() {
             std::cerr << "⚠️ Skipping entry without 'midstate'\n";
             continue;
         }
-        std::string midstate_hex = entry["midstate"];
-        unique_midstates.insert(midstate_hex);
+        const std::string& midstate_hex = entry["midstate"];
+        uint8_t bytes[32];
+        if (midstate_hex.size() != 64 || !hexDecode(midstate_hex, bytes)) {
+            std::cerr << "⚠️ Skipping malformed midstate\n";
+            continue;
+        }
+        unique_midstates.insert(bytes);
         ++count;
     }
 
@@ -45,10 +41,9 @@ int main() {
 
     // Print first 5 unique midstates as a sample
     int printed = 0;
-    for (const auto& m : unique_midstates) {
-        std::cout << m << "\n";
-        if (++printed >= 5) break;
-    }
+    unique_midstates.forEach([&](const MidstateKey& m) {
+        if (printed++ < 5) std::cout << hexEncode(m.data(), m.size()) << "\n";
+    });
 
     return 0;
 }
@@ -0,0 +1,179 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "header_ingest.hpp"
+#include "midstate_batch.hpp"
+#include "midstate_stream.hpp"
+#include "npy_writer.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+
+// Avalanche analysis of real headers: every one of the 640 input bits is
+// flipped and the double SHA-256 re-run, recording how many output bits change:
+//
+//   avalanche_profile [--headers oracle/block_headers.json | --raw headers.bin] [--limit N]
+//                     [--out oracle/avalanche.json] [--npy profiles.npy]
+//
+// An ideal hash changes Binomial(256, 1/2) bits per flip: mean 128, sd 8.
+// The report has per-header and per-input-bit means with z-scores against
+// that; --npy also writes the full headers x 640 distance matrix (uint16).
+
+// Headers profiled per batch
+constexpr size_t kBatchSize = 1024;
+
+constexpr double kIdealMean = 128.0;
+constexpr double kIdealVariance = 64.0;
+
+int main(int argc, char** argv) {
+    std::string headersPath = "oracle/block_headers.json";
+    std::string rawPath;
+    std::string outPath = "oracle/avalanche.json";
+    std::string npyPath;
+    size_t limit = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--headers") headersPath = argv[i + 1];
+        else if (arg == "--raw") rawPath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--npy") npyPath = argv[i + 1];
+        else if (arg == "--limit") limit = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Header80> headers;
+    std::vector<int64_t> heights;
+    if (!rawPath.empty()) {
+        if (!readRawHeaderFile(rawPath, headers)) {
+            std::cerr << "❌ Error: cannot read " << rawPath << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < headers.size(); ++i) heights.push_back(static_cast<int64_t>(i));
+    } else {
+        std::ifstream in(headersPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << headersPath << " not found.\n";
+            return 1;
+        }
+        std::string error;
+        bool ok = streamHeaders(in, [&](HeaderRecord&& h) {
+            Header80 header;
+            if (h.headerHex.size() != 160 || !hexDecode(h.headerHex, header.bytes)) return;
+            headers.push_back(header);
+            heights.push_back(h.height);
+        }, &error);
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << headersPath << ": " << error << "\n";
+            return 1;
+        }
+    }
+    if (limit && headers.size() > limit) {
+        headers.resize(limit);
+        heights.resize(limit);
+    }
+    if (headers.empty()) {
+        std::cerr << "❌ Error: no headers to profile\n";
+        return 1;
+    }
+
+    NpyWriter npy;
+    if (!npyPath.empty() && !npy.open(npyPath, "<u2", kHeaderBits, sizeof(uint16_t))) {
+        std::cerr << "❌ Error: Could not write to " << npyPath << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    json perHeader = json::array();
+    std::vector<double> bitSum(kHeaderBits, 0.0);
+    uint64_t histogram[257] = {};
+    double sum = 0.0, sumSq = 0.0;
+    std::vector<AvalancheProfile> profiles;
+
+    for (size_t begin = 0; begin < headers.size(); begin += kBatchSize) {
+        size_t n = std::min(kBatchSize, headers.size() - begin);
+        profiles.resize(n);
+        avalancheProfiles(std::span<const Header80>(headers).subspan(begin, n), profiles);
+
+        for (size_t i = 0; i < n; ++i) {
+            const AvalancheProfile& p = profiles[i];
+            double hSum = 0.0;
+            for (size_t b = 0; b < kHeaderBits; ++b) {
+                hSum += p[b];
+                bitSum[b] += p[b];
+                sumSq += double(p[b]) * p[b];
+                ++histogram[p[b]];
+            }
+            sum += hSum;
+            double mean = hSum / kHeaderBits;
+            perHeader.push_back({
+                {"height", heights[begin + i]},
+                {"mean", mean},
+                {"min", *std::min_element(p.begin(), p.end())},
+                {"max", *std::max_element(p.begin(), p.end())},
+                {"z", (mean - kIdealMean) / std::sqrt(kIdealVariance / kHeaderBits)}
+            });
+        }
+        if (!npyPath.empty() && !npy.append(profiles.data(), n)) {
+            std::cerr << "❌ Error: Could not write to " << npyPath << "\n";
+            return 1;
+        }
+    }
+    double ms = msSince(start);
+
+    const double flips = static_cast<double>(headers.size()) * kHeaderBits;
+    const double mean = sum / flips;
+    const double sd = std::sqrt(std::max(0.0, sumSq / flips - mean * mean));
+    std::cout << "🌊 " << headers.size() << " headers x " << kHeaderBits << " flips = " << flips << " hashes ["
+              << ms << " ms, " << flips / (ms * 1e3) << " M/s]\n";
+    std::cout << "📊 Output bits changed: mean " << mean << " (ideal 128), sd " << sd << " (ideal 8)\n";
+
+    // Input bits whose flips move the output least or most, against the ideal spread
+    json perBit = json::array();
+    size_t worst = 0;
+    double worstZ = 0.0;
+    for (size_t b = 0; b < kHeaderBits; ++b) {
+        double bitMean = bitSum[b] / headers.size();
+        double z = (bitMean - kIdealMean) / std::sqrt(kIdealVariance / headers.size());
+        perBit.push_back({{"bit", b}, {"mean", bitMean}, {"z", z}});
+        if (std::fabs(z) > std::fabs(worstZ)) {
+            worst = b;
+            worstZ = z;
+        }
+    }
+    std::cout << "   Most deviant input bit " << worst << " (byte " << worst / 8 << "), z " << worstZ << "\n";
+
+    if (!npyPath.empty()) {
+        if (!npy.commit()) {
+            std::cerr << "❌ Error: Could not write to " << npyPath << "\n";
+            return 1;
+        }
+        std::cout << "✅ Saved profiles to " << npyPath << "\n";
+    }
+
+    json report = {
+        {"headers", headers.size()},
+        {"mean", mean},
+        {"sd", sd},
+        {"histogram", std::vector<uint64_t>(std::begin(histogram), std::end(histogram))},
+        {"bits", perBit},
+        {"per_header", perHeader}
+    };
+    std::ofstream out(outPath);
+    out << report.dump(2);
+    if (!out) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "✅ Saved avalanche report to " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include <iostream>
+#include <fstream>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "oracle_store.hpp"
+#include "oracle_weights.hpp"
+#include "parallel.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+
+// Backtests the oracle score against the quality of the real block hashes:
+//
+//   backtest_oracle [--store oracle/midstates.bin] [--weights oracle/oracle_weights.json]
+//                   [--label excess|zeros] [--hit-bits 4] [--bootstrap 200] [--seed 1]
+//                   [--out oracle/backtest.json]
+//
+// Real store rows are scored the way oracle_dispatcher scores it. When the
+// weights record the newest height fit_weights trained on, only rows above
+// it are evaluated, so the numbers are out of sample; weights without that
+// height are evaluated on every row and flagged as in-sample. The
+// label is the block hash's leading zero bits beyond those its target
+// required ("excess", geometric with p = 1/2 if the score carries no signal)
+// or the raw count ("zeros", which mostly tracks difficulty). Reports the
+// Spearman rank correlation, a lift curve over score deciles and top-K
+// enrichment of hits (label >= --hit-bits), with 95% intervals from a
+// Poisson bootstrap whose replicates run in parallel.
+
+constexpr size_t kLiftBins = 10;
+const double kTopFractions[] = {0.001, 0.01, 0.05, 0.1};
+constexpr size_t kTopCount = sizeof(kTopFractions) / sizeof(kTopFractions[0]);
+
+// Ranks 1..n, ties sharing their average rank
+std::vector<double> averageRanks(const std::vector<double>& v) {
+    std::vector<uint32_t> idx(v.size());
+    std::iota(idx.begin(), idx.end(), 0u);
+    std::sort(idx.begin(), idx.end(), [&](uint32_t a, uint32_t b) { return v[a] < v[b]; });
+    std::vector<double> ranks(v.size());
+    for (size_t i = 0; i < idx.size();) {
+        size_t j = i;
+        while (j < idx.size() && v[idx[j]] == v[idx[i]]) ++j;
+        double r = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; ++k) ranks[idx[k]] = r;
+        i = j;
+    }
+    return ranks;
+}
+
+// Poisson(1) inverse CDF over 16-bit uniforms; tail mass below 2^-16 lands in the last entry
+struct PoissonTable {
+    uint8_t k[1 << 16];
+    PoissonTable() {
+        double cdf = 0.0, p = std::exp(-1.0);
+        uint32_t draw = 0;
+        for (uint32_t u = 0; u < (1u << 16); ++u) {
+            while (draw < 12 && (u + 0.5) / 65536.0 > cdf + p) {
+                cdf += p;
+                p /= ++draw;
+            }
+            k[u] = static_cast<uint8_t>(draw);
+        }
+    }
+};
+
+// Fills w with Poisson(1) weights, four per 64-bit draw
+void poissonWeights(uint64_t& state, uint8_t* w, size_t n) {
+    static const PoissonTable table;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint64_t r = splitmix64(state);
+        w[i] = table.k[r & 0xFFFF];
+        w[i + 1] = table.k[(r >> 16) & 0xFFFF];
+        w[i + 2] = table.k[(r >> 32) & 0xFFFF];
+        w[i + 3] = table.k[r >> 48];
+    }
+    for (uint64_t r = splitmix64(state); i < n; ++i, r >>= 16) w[i] = table.k[r & 0xFFFF];
+}
+
+struct Metrics {
+    double spearman = 0.0;
+    double meanLabel = 0.0;
+    double hitRate = 0.0;
+    std::array<double, kLiftBins> lift{};       // mean label in score decile / overall mean
+    std::array<double, kTopCount> enrichment{}; // hit rate in top fraction / overall hit rate
+};
+
+// Rows laid out in descending score order, so each replicate is two sequential passes
+struct Sample {
+    std::vector<double> scoreRank, labelRank, label;
+    std::vector<uint8_t> hit;
+};
+
+// Metrics with per-row weights: 1 for the point estimate, Poisson(1) for a
+// bootstrap replicate. Spearman is the weighted Pearson of full-sample ranks.
+Metrics evaluate(const Sample& s, uint64_t* rng, std::vector<uint8_t>& w) {
+    const size_t n = s.label.size();
+    w.resize(n);
+    if (rng) poissonWeights(*rng, w.data(), n);
+    else std::fill(w.begin(), w.end(), 1);
+    double sw = 0, sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0, sl = 0, sh = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double wi = w[i];
+        double x = s.scoreRank[i], y = s.labelRank[i];
+        sw += wi;
+        sx += wi * x;
+        sy += wi * y;
+        sxx += wi * x * x;
+        syy += wi * y * y;
+        sxy += wi * x * y;
+        sl += wi * s.label[i];
+        sh += wi * s.hit[i];
+    }
+
+    Metrics m;
+    if (sw == 0) return m;
+    double cov = sxy / sw - (sx / sw) * (sy / sw);
+    double vx = sxx / sw - (sx / sw) * (sx / sw), vy = syy / sw - (sy / sw) * (sy / sw);
+    m.spearman = vx > 0 && vy > 0 ? cov / std::sqrt(vx * vy) : 0.0;
+    m.meanLabel = sl / sw;
+    m.hitRate = sh / sw;
+
+    // Deciles and top fractions by cumulative weight, best score first. Rows
+    // before each boundary form a prefix, so one running sum serves them all.
+    std::array<double, kLiftBins> binWeight{}, binLabel{};
+    std::array<double, kTopCount> topWeight{}, topHits{};
+    double cum = 0, cumHits = 0;
+    size_t bin = 0, top = 0;
+    double binEnd = sw / kLiftBins;
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t wi = w[i];
+        if (!wi) continue;
+        while (top < kTopCount && cum >= kTopFractions[top] * sw) {
+            topWeight[top] = cum;
+            topHits[top++] = cumHits;
+        }
+        while (bin + 1 < kLiftBins && cum >= binEnd) binEnd = sw * (++bin + 1) / kLiftBins;
+        binWeight[bin] += wi;
+        binLabel[bin] += wi * s.label[i];
+        cum += wi;
+        cumHits += wi * s.hit[i];
+    }
+    for (; top < kTopCount; ++top) {
+        topWeight[top] = cum;
+        topHits[top] = cumHits;
+    }
+    for (size_t b = 0; b < kLiftBins; ++b)
+        m.lift[b] = binWeight[b] > 0 && m.meanLabel > 0 ? binLabel[b] / binWeight[b] / m.meanLabel : 0.0;
+    for (size_t t = 0; t < kTopCount; ++t)
+        m.enrichment[t] = topWeight[t] > 0 && m.hitRate > 0 ? topHits[t] / topWeight[t] / m.hitRate : 0.0;
+    return m;
+}
+
+// 2.5% and 97.5% percentiles
+std::pair<double, double> interval(std::vector<double> v) {
+    if (v.empty()) return {0.0, 0.0};
+    std::sort(v.begin(), v.end());
+    auto at = [&](double q) { return v[std::min(v.size() - 1, static_cast<size_t>(q * v.size()))]; };
+    return {at(0.025), at(0.975)};
+}
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string weightsPath = "oracle/oracle_weights.json";
+    std::string outPath = "oracle/backtest.json";
+    std::string labelName = "excess";
+    double hitBits = 4.0;
+    size_t replicates = 200;
+    uint64_t seed = 1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--weights") weightsPath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--label") labelName = argv[i + 1];
+        else if (arg == "--hit-bits") hitBits = std::stod(argv[i + 1]);
+        else if (arg == "--bootstrap") replicates = std::stoul(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoull(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (labelName != "excess" && labelName != "zeros") {
+        std::cerr << "❌ --label must be excess or zeros\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    OracleWeights weights;
+    bool fitted = loadWeights(weightsPath, weights);
+    if (!fitted) {
+        std::cerr << "⚠️ Using default score weights\n";
+        weights = OracleWeights{};
+    }
+    bool inSample = fitted && weights.fitMaxHeight < 0;
+    if (inSample) {
+        std::cerr << "⚠️ " << weightsPath << " does not record the heights it was fitted on; backtesting IN-SAMPLE,"
+                  << " so these numbers overstate the score. Refit with fit_weights --holdout.\n";
+    }
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    // Pattern histogram over every real row, as in fit_weights; evaluated rows are those the fit never saw
+    std::vector<uint32_t> rows;
+    uint64_t prefixCounts[256] = {};
+    size_t realRows = 0;
+    rows.reserve(store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store[i].flags & kStoreSynthetic) continue;
+        ++realRows;
+        ++prefixCounts[store[i].midstate[0]];
+        if (static_cast<int64_t>(store[i].height) > weights.fitMaxHeight) rows.push_back(static_cast<uint32_t>(i));
+    }
+    const size_t n = rows.size();
+    if (n < 2) {
+        std::cerr << "❌ Error: need at least 2 real rows";
+        if (weights.fitMaxHeight >= 0) std::cerr << " above fitted height " << weights.fitMaxHeight;
+        std::cerr << " in " << storePath << ", have " << n << "; refit with fit_weights --holdout\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> midstates(n * 32), tails(n * 16);
+    std::vector<double> pattern(n);
+    for (size_t i = 0; i < n; ++i) {
+        const StoreRecord& rec = store[rows[i]];
+        std::copy(rec.midstate, rec.midstate + 32, &midstates[i * 32]);
+        std::copy(rec.tail, rec.tail + 16, &tails[i * 16]);
+    }
+    double maxCount = static_cast<double>(*std::max_element(std::begin(prefixCounts), std::end(prefixCounts)));
+    for (size_t i = 0; i < n; ++i) pattern[i] = prefixCounts[midstates[i * 32]] / maxCount;
+
+    std::vector<FeatureVector> features(n);
+    computeFeatureRows(midstates.data(), tails.data(), pattern.data(), n, features.data());
+
+    std::vector<double> scores(n), labels(n);
+    parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            scores[i] = weights.score(features[i]);
+            double zeros = leadingZeroBits(store[rows[i]].blockhash);
+            labels[i] = labelName == "zeros" ? zeros : std::max(0.0, zeros - features[i][kColTargetZeros]);
+        }
+    });
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+    });
+    std::vector<double> scoreRank = averageRanks(scores), labelRank = averageRanks(labels);
+    Sample sample;
+    sample.scoreRank.resize(n);
+    sample.labelRank.resize(n);
+    sample.label.resize(n);
+    sample.hit.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t r = order[i];
+        sample.scoreRank[i] = scoreRank[r];
+        sample.labelRank[i] = labelRank[r];
+        sample.label[i] = labels[r];
+        sample.hit[i] = labels[r] >= hitBits;
+    }
+    std::cout << "📐 " << n << " of " << realRows << " rows scored";
+    if (weights.fitMaxHeight >= 0) std::cout << " (heights > " << weights.fitMaxHeight << ", held out of the fit)";
+    else if (inSample) std::cout << " (in-sample)";
+    std::cout << " [" << msSince(start) << " ms]\n";
+
+    std::vector<uint8_t> pointWeights;
+    Metrics point = evaluate(sample, nullptr, pointWeights);
+
+    // Bootstrap replicates, each with its own seed so results do not depend on thread count
+    auto bootStart = std::chrono::steady_clock::now();
+    std::vector<Metrics> boot(replicates);
+    parallelFor(replicates, [&](size_t begin, size_t end) {
+        std::vector<uint8_t> w;
+        for (size_t b = begin; b < end; ++b) {
+            uint64_t state = seed ^ ((b + 1) * 0xD1B54A32D192ED03ull);
+            boot[b] = evaluate(sample, &state, w);
+        }
+    }, 1);
+    double bootMs = msSince(bootStart);
+
+    auto collect = [&](auto get) {
+        std::vector<double> v;
+        for (const Metrics& m : boot) v.push_back(get(m));
+        return interval(v);
+    };
+
+    auto rho = collect([](const Metrics& m) { return m.spearman; });
+    std::cout << "🧪 Label: " << (labelName == "zeros" ? "leading zero bits" : "excess zero bits over target")
+              << ", mean " << point.meanLabel << ", hit rate (>= " << hitBits << ") " << point.hitRate << "\n";
+    std::cout << "📊 Spearman " << point.spearman << " [" << rho.first << ", " << rho.second << "]\n";
+
+    json lift = json::array();
+    std::cout << "📈 Lift by score decile (best first):";
+    for (size_t b = 0; b < kLiftBins; ++b) {
+        auto ci = collect([b](const Metrics& m) { return m.lift[b]; });
+        std::cout << " " << point.lift[b];
+        lift.push_back({{"decile", b + 1}, {"lift", point.lift[b]}, {"ci", {ci.first, ci.second}}});
+    }
+    std::cout << "\n";
+
+    json enrichment = json::array();
+    for (size_t t = 0; t < kTopCount; ++t) {
+        auto ci = collect([t](const Metrics& m) { return m.enrichment[t]; });
+        std::cout << "🎯 Top " << 100 * kTopFractions[t] << "%: enrichment " << point.enrichment[t] << " ["
+                  << ci.first << ", " << ci.second << "]\n";
+        enrichment.push_back({{"top_fraction", kTopFractions[t]}, {"enrichment", point.enrichment[t]},
+                              {"ci", {ci.first, ci.second}}});
+    }
+    std::cout << "🔁 " << replicates << " bootstrap replicates [" << bootMs << " ms]\n";
+
+    json report = {
+        {"store", storePath},
+        {"rows", n},
+        {"real_rows", realRows},
+        {"fit_max_height", weights.fitMaxHeight},
+        {"in_sample", inSample},
+        {"label", labelName},
+        {"hit_bits", hitBits},
+        {"mean_label", point.meanLabel},
+        {"hit_rate", point.hitRate},
+        {"spearman", point.spearman},
+        {"spearman_ci", {rho.first, rho.second}},
+        {"lift", lift},
+        {"enrichment", enrichment},
+        {"bootstrap", replicates},
+        {"weights", {{"bias", weights.bias}, {"w", weights.w}}}
+    };
+    std::ofstream out(outPath);
+    out << report.dump(2);
+    if (!out) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "✅ Saved backtest to " << outPath << " [" << msSince(start) << " ms]\n";
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <cstring>
+#include "byte_histogram.hpp"
+#include "oracle_utils.hpp"
+
+// Benchmarks the byte-histogram entropy kernels against the original
+// single-table loop from shannonEntropy():
+//
+//   bench_entropy [--mb 256] [--file oracle/midstates.bin] [--window 4096] [--repeat 3]
+//
+// Buffers: uniform random bytes, all zeros, a 4-symbol alphabet and, with
+// --file, the file's contents. The sliding-window check compares
+// SlidingEntropy against recomputing every window from scratch on a 1 MB prefix.
+
+// shannonEntropy() before the multi-table kernel
+double singleTableEntropy(const uint8_t* data, size_t length) {
+    uint64_t counts[256] = {0};
+    for (size_t i = 0; i < length; i++) counts[data[i]]++;
+    double entropy = 0.0;
+    for (int i = 0; i < 256; i++) {
+        if (counts[i] == 0) continue;
+        double p = (double)counts[i] / length;
+        entropy -= p * log2(p);
+    }
+    return entropy;
+}
+
+template <typename Fn>
+double bestOf(size_t repeat, Fn fn) {
+    double best = 1e300;
+    for (size_t r = 0; r < repeat; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, msSince(start));
+    }
+    return best;
+}
+
+void benchBuffer(const std::string& name, const std::vector<uint8_t>& data, size_t repeat) {
+    double ref = 0.0, fast = 0.0;
+    double refMs = bestOf(repeat, [&] { ref = singleTableEntropy(data.data(), data.size()); });
+    double fastMs = bestOf(repeat, [&] { fast = entropy::buffer_entropy(data.data(), data.size()); });
+    double mb = data.size() / 1e6;
+    std::cout << "📊 " << name << ": entropy " << fast << " (|diff| " << std::fabs(fast - ref) << ")\n"
+              << "   single table " << refMs << " ms (" << mb / refMs << " GB/s), "
+              << entropy::kHistogramTables << " tables " << fastMs << " ms (" << mb / fastMs << " GB/s), "
+              << refMs / fastMs << "x\n";
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = 256;
+    size_t window = 4096;
+    size_t repeat = 3;
+    std::string filePath;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--mb") megabytes = std::stoul(argv[i + 1]);
+        else if (arg == "--file") filePath = argv[i + 1];
+        else if (arg == "--window") window = std::stoul(argv[i + 1]);
+        else if (arg == "--repeat") repeat = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (megabytes == 0 || window == 0 || repeat == 0) {
+        std::cerr << "❌ --mb, --window and --repeat must be positive\n";
+        return 1;
+    }
+
+    const size_t n = megabytes << 20;
+    std::mt19937_64 rng(1);
+    std::vector<uint8_t> data(n);
+    for (size_t i = 0; i + 8 <= n; i += 8) {
+        uint64_t r = rng();
+        std::memcpy(&data[i], &r, 8);
+    }
+    benchBuffer("random", data, repeat);
+
+    std::vector<uint8_t> zeros(n, 0);
+    benchBuffer("zeros", zeros, repeat);
+
+    std::vector<uint8_t> small(n);
+    for (size_t i = 0; i < n; ++i) small[i] = "ACGT"[data[i] & 3];
+    benchBuffer("4 symbols", small, repeat);
+
+    if (!filePath.empty()) {
+        std::ifstream in(filePath, std::ios::binary);
+        if (!in) {
+            std::cerr << "❌ Error: cannot read " << filePath << "\n";
+            return 1;
+        }
+        std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        benchBuffer(filePath, file, repeat);
+    }
+
+    // Sliding window against recomputing each window
+    const size_t prefix = std::min<size_t>(n, size_t(1) << 20);
+    if (prefix < window) {
+        std::cerr << "❌ --window is larger than the buffer\n";
+        return 1;
+    }
+    const size_t positions = prefix - window + 1;
+    std::vector<double> sliding;
+    double slideMs = bestOf(repeat, [&] { entropy::sliding_entropy(small.data(), prefix, window, sliding); });
+
+    std::vector<double> naive(positions);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < positions; ++i) naive[i] = singleTableEntropy(small.data() + i, window);
+    double naiveMs = msSince(start);
+
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < positions; ++i) maxDiff = std::max(maxDiff, std::fabs(naive[i] - sliding[i]));
+    std::cout << "🪟 Sliding window " << window << " over " << positions << " positions: " << slideMs
+              << " ms (" << positions / (slideMs * 1e3) << " M/s), recompute " << naiveMs << " ms, "
+              << naiveMs / slideMs << "x, max |diff| " << maxDiff << "\n";
+    return 0;
+}
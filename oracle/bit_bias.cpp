@@ -0,0 +1,180 @@
+#include "bit_bias.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Lane helpers are internal; the by-value vector ABI note does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace {
+
+#if defined(__AVX512F__)
+constexpr size_t kLaneBytes = 64;
+#elif defined(__AVX__)
+constexpr size_t kLaneBytes = 32;
+#else
+constexpr size_t kLaneBytes = 16;
+#endif
+constexpr size_t kLaneWords = kLaneBytes / 8;
+
+// 64-bit words, loaded and stored without alignment requirements
+typedef uint64_t Lane __attribute__((vector_size(kLaneBytes), aligned(8)));
+
+constexpr size_t kGroupRows = 16;
+
+// ones, twos, fours, eights, then the sixteens counter
+constexpr size_t kSlicePlanes = 4;
+constexpr size_t kCounterPlanes = 8;
+constexpr size_t kPlanes = kSlicePlanes + kCounterPlanes;
+
+// Groups the sixteens counter holds before it would overflow
+constexpr uint32_t kMaxPendingGroups = (1u << kCounterPlanes) - 1;
+
+constexpr uint64_t planeWeight(size_t p) {
+    return p < kSlicePlanes ? uint64_t(1) << p : uint64_t(16) << (p - kSlicePlanes);
+}
+
+// Carry-save adder: h:l = a + b + c
+inline void csa(Lane& h, Lane& l, Lane a, Lane b, Lane c) {
+    Lane u = a ^ b;
+    h = (a & b) | (u & c);
+    l = u ^ c;
+}
+
+inline Lane loadLane(const uint8_t* p) {
+    Lane v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+BitPositionCounter::BitPositionCounter(size_t rowBytes)
+    : rowBytes(rowBytes),
+      lanes((rowBytes + kLaneBytes - 1) / kLaneBytes),
+      planes(kPlanes * lanes * kLaneWords, 0),
+      totals(rowBytes * 8, 0),
+      lastLaneMask(kLaneWords, 0) {
+    uint8_t* mask = reinterpret_cast<uint8_t*>(lastLaneMask.data());
+    std::fill(mask, mask + rowBytes - (lanes - 1) * kLaneBytes, 0xFF);
+}
+
+void BitPositionCounter::addGroup(const uint8_t* const rowPtrs[16]) {
+    Lane* state = reinterpret_cast<Lane*>(planes.data());
+    for (size_t l = 0; l < lanes; ++l) {
+        Lane d[kGroupRows];
+        for (size_t r = 0; r < kGroupRows; ++r) d[r] = loadLane(rowPtrs[r] + l * kLaneBytes);
+        // Bytes past the end of the row belong to the next record
+        if (l + 1 == lanes) {
+            Lane mask = loadLane(reinterpret_cast<const uint8_t*>(lastLaneMask.data()));
+            for (size_t r = 0; r < kGroupRows; ++r) d[r] &= mask;
+        }
+
+        Lane* p = state + l * kPlanes;
+        Lane ones = p[0], twos = p[1], fours = p[2], eights = p[3];
+        Lane twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+
+        // Harley-Seal: 16 rows in, one carry of weight 16 out
+        csa(twosA, ones, ones, d[0], d[1]);
+        csa(twosB, ones, ones, d[2], d[3]);
+        csa(foursA, twos, twos, twosA, twosB);
+        csa(twosA, ones, ones, d[4], d[5]);
+        csa(twosB, ones, ones, d[6], d[7]);
+        csa(foursB, twos, twos, twosA, twosB);
+        csa(eightsA, fours, fours, foursA, foursB);
+        csa(twosA, ones, ones, d[8], d[9]);
+        csa(twosB, ones, ones, d[10], d[11]);
+        csa(foursA, twos, twos, twosA, twosB);
+        csa(twosA, ones, ones, d[12], d[13]);
+        csa(twosB, ones, ones, d[14], d[15]);
+        csa(foursB, twos, twos, twosA, twosB);
+        csa(eightsB, fours, fours, foursA, foursB);
+        csa(sixteens, eights, eights, eightsA, eightsB);
+
+        p[0] = ones;
+        p[1] = twos;
+        p[2] = fours;
+        p[3] = eights;
+
+        // Ripple the sixteens into the vertical counter
+        Lane carry = sixteens;
+#pragma GCC unroll 8
+        for (size_t c = kSlicePlanes; c < kPlanes; ++c) {
+            Lane t = p[c] & carry;
+            p[c] ^= carry;
+            carry = t;
+        }
+    }
+}
+
+void BitPositionCounter::extract(std::vector<uint64_t>& out) const {
+    for (size_t l = 0; l < lanes; ++l) {
+        for (size_t p = 0; p < kPlanes; ++p) {
+            const uint64_t* words = &planes[(l * kPlanes + p) * kLaneWords];
+            for (size_t w = 0; w < kLaneWords; ++w) {
+                size_t byteBase = l * kLaneBytes + w * 8;
+                for (uint64_t v = words[w]; v; v &= v - 1) {
+                    unsigned b = static_cast<unsigned>(__builtin_ctzll(v));
+                    size_t byte = byteBase + b / 8;
+                    if (byte < rowBytes) out[byte * 8 + 7 - b % 8] += planeWeight(p);
+                }
+            }
+        }
+    }
+}
+
+void BitPositionCounter::flush() {
+    extract(totals);
+    std::fill(planes.begin(), planes.end(), 0);
+    pendingGroups = 0;
+}
+
+void BitPositionCounter::add(const uint8_t* rows, size_t stride, size_t n) {
+    if (n == 0) return;
+    const size_t span = lanes * kLaneBytes;
+    const uint8_t* end = rows + (n - 1) * stride + rowBytes;
+
+    // Rows whose lane loads would run past the input are copied, zero-padded;
+    // short groups are filled with zero rows
+    std::vector<uint8_t> stage((kGroupRows + 1) * span, 0);
+    const uint8_t* zeroRow = &stage[kGroupRows * span];
+
+    for (size_t i = 0; i < n; i += kGroupRows) {
+        size_t m = std::min(kGroupRows, n - i);
+        const uint8_t* ptrs[kGroupRows];
+        for (size_t r = 0; r < kGroupRows; ++r) {
+            const uint8_t* row = rows + (i + r) * stride;
+            if (r >= m) {
+                ptrs[r] = zeroRow;
+            } else if (row + span <= end) {
+                ptrs[r] = row;
+            } else {
+                std::memcpy(&stage[r * span], row, rowBytes);
+                ptrs[r] = &stage[r * span];
+            }
+        }
+        addGroup(ptrs);
+        rowCount += m;
+        if (++pendingGroups == kMaxPendingGroups) flush();
+    }
+}
+
+void BitPositionCounter::merge(const BitPositionCounter& other) {
+    std::vector<uint64_t> c = other.counts();
+    for (size_t i = 0; i < totals.size(); ++i) totals[i] += c[i];
+    rowCount += other.rowCount;
+}
+
+std::vector<uint64_t> BitPositionCounter::counts() const {
+    std::vector<uint64_t> out = totals;
+    extract(out);
+    return out;
+}
+
+BitBias bitBias(uint64_t ones, uint64_t rows) {
+    if (rows == 0) return {0.0, 0.0};
+    double n = static_cast<double>(rows);
+    return {ones / n - 0.5, (ones - n / 2.0) / std::sqrt(n / 4.0)};
+}
@@ -0,0 +1,51 @@
+// bit_bias.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counts how often each bit position is set across fixed-width rows.
+//
+// Rows are taken 16 at a time and reduced with a Harley-Seal carry-save
+// tree into bit-sliced vertical counters (ones, twos, fours, eights, then an
+// 8-plane ripple counter of sixteens), so every 64-bit word of a SIMD lane
+// counts 64 bit positions at once and per-position totals are only
+// extracted every 4080 rows. Bit position p is bit 7 - p % 8 of byte p / 8,
+// the order hex and bit strings are written in.
+class BitPositionCounter {
+public:
+    explicit BitPositionCounter(size_t rowBytes);
+
+    // Adds n rows of rowBytes each, `stride` bytes apart
+    void add(const uint8_t* rows, size_t stride, size_t n);
+
+    // Folds another counter over the same row width into this one
+    void merge(const BitPositionCounter& other);
+
+    uint64_t rows() const { return rowCount; }
+    size_t bits() const { return rowBytes * 8; }
+
+    // One counts per bit position
+    std::vector<uint64_t> counts() const;
+
+private:
+    void addGroup(const uint8_t* const rowPtrs[16]);
+    void flush();
+    void extract(std::vector<uint64_t>& out) const;
+
+    size_t rowBytes;
+    size_t lanes;                  // SIMD lanes per row
+    std::vector<uint64_t> planes;  // kPlanes x lanes vectors, bit-sliced counters
+    std::vector<uint64_t> totals;  // flushed counts per bit position
+    std::vector<uint64_t> lastLaneMask;  // keeps the row's bytes of its last lane
+    uint64_t rowCount = 0;
+    uint32_t pendingGroups = 0;
+};
+
+// Per-position deviation from a fair coin over `rows` samples
+struct BitBias {
+    double bias;  // P(bit = 1) - 0.5
+    double z;     // (ones - rows / 2) / sqrt(rows / 4)
+};
+
+BitBias bitBias(uint64_t ones, uint64_t rows);
@@ -2,53 +2,45 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <sstream>
-#include <iomanip>
-#include <openssl/sha.h>
 #include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "midstate_batch.hpp"
+#include "midstate_stream.hpp"
+#include "parallel.hpp"
 
 using json = nlohmann::json;
 
-// Converts a hex string to a vector of bytes
-std::vector<uint8_t> hexToBytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    if (hex.length() % 2 != 0) {
-        std::cerr << "Warning: hex string has odd length\n";
-        return bytes;
-    }
-
-    for (size_t i = 0; i < hex.length(); i += 2)
-        bytes.push_back(static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+// Headers processed per parallel batch; bounds memory independent of input size
+constexpr size_t kBatchSize = 8192;
 
-    return bytes;
-}
+// Computes midstates for a batch and appends the entries to the output in input order
+void flushBatch(std::vector<HeaderRecord>& batch, JsonArrayWriter& writer) {
+    std::vector<Header80> headers(batch.size());
+    std::vector<char> valid(batch.size(), 0);
 
-// Converts a byte vector to a hex string
-std::string bytesToHex(const std::vector<uint8_t>& bytes) {
-    std::ostringstream oss;
-    for (uint8_t b : bytes)
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)b;
-    return oss.str();
-}
-
-// Extracts SHA256 midstate from the first 64 bytes
-std::string sha256Midstate(const std::vector<uint8_t>& header64) {
-    if (header64.size() != 64) {
-        throw std::runtime_error("Expected exactly 64 bytes for midstate input");
-    }
+    parallelFor(batch.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const std::string& hex = batch[i].headerHex;
+            valid[i] = hex.size() == 160 && hexDecode(hex, headers[i].bytes);
+        }
+    }, 256);
 
-    SHA256_CTX ctx;
-    SHA256_Init(&ctx);
-    SHA256_Update(&ctx, header64.data(), header64.size());
+    // SHA-256 of all 64-byte prefixes in SIMD lanes; hex only for the JSON output
+    std::vector<Midstate> midstates(batch.size());
+    computeMidstates(headers, midstates);
 
-    // Midstate is internal SHA256 state after processing one block
-    std::ostringstream oss;
-    for (int i = 0; i < 8; ++i) {
-        uint32_t word = ctx.h[i];
-        for (int b = 3; b >= 0; --b)
-            oss << std::hex << std::setw(2) << std::setfill('0') << ((word >> (b * 8)) & 0xff);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!valid[i]) {
+            std::cerr << "⚠️ Skipping block with header size != 80 bytes\n";
+            continue;
+        }
+        writer.write({
+            {"blockhash", batch[i].hash},
+            {"midstate", midstateToHex(midstates[i])},
+            {"tail", hexEncode(headers[i].bytes + 64, 16)}
+        });
     }
-    return oss.str();
+    batch.clear();
 }
 
 int main() {
@@ -58,58 +50,36 @@ int main() {
         return 1;
     }
 
-    json blocks;
-    try {
-        in >> blocks;
-    } catch (const std::exception& e) {
-        std::cerr << "❌ JSON parsing error: " << e.what() << "\n";
+    JsonArrayWriter writer;
+    if (!writer.open("oracle/midstates.json")) {
+        std::cerr << "❌ Cannot write to oracle/midstates.json\n";
         return 1;
     }
 
-    json out = json::array();
+    std::vector<HeaderRecord> batch;
+    batch.reserve(kBatchSize);
 
-    for (const auto& b : blocks) {
-        if (!b.contains("hash") || !b.contains("header_hex")) {
+    std::string error;
+    bool ok = streamHeaders(in, [&](HeaderRecord&& b) {
+        if (b.hash.empty() || b.headerHex.empty()) {
             std::cerr << "⚠️ Skipping malformed block (missing hash or header_hex)\n";
-            continue;
+            return;
         }
+        batch.push_back(std::move(b));
+        if (batch.size() == kBatchSize) flushBatch(batch, writer);
+    }, &error);
 
-        std::string blockhash = b["hash"];
-        std::string headerHex = b["header_hex"];
-        auto headerBytes = hexToBytes(headerHex);
-
-        if (headerBytes.size() != 80) {
-            std::cerr << "⚠️ Skipping block with header size != 80 bytes\n";
-            continue;
-        }
-
-        std::vector<uint8_t> first64(headerBytes.begin(), headerBytes.begin() + 64);
-        std::vector<uint8_t> tail(headerBytes.begin() + 64, headerBytes.end());
-
-        std::string midstate;
-        try {
-            midstate = sha256Midstate(first64);
-        } catch (const std::exception& e) {
-            std::cerr << "❌ Error computing midstate: " << e.what() << "\n";
-            continue;
-        }
-
-        std::string tailHex = bytesToHex(tail);
-
-        out.push_back({
-            {"blockhash", blockhash},
-            {"midstate", midstate},
-            {"tail", tailHex}
-        });
+    if (!ok) {
+        std::cerr << "❌ JSON parsing error: " << error << "\n";
+        return 1;
     }
+    flushBatch(batch, writer);
 
-    std::ofstream outFile("oracle/midstates.json");
-    if (!outFile) {
+    if (!writer.commit()) {
         std::cerr << "❌ Cannot write to oracle/midstates.json\n";
         return 1;
     }
 
-    outFile << out.dump(2);
-    std::cout << "✅ Wrote " << out.size() << " entries to oracle/midstates.json\n";
+    std::cout << "✅ Wrote " << writer.size() << " entries to oracle/midstates.json\n";
     return 0;
 }
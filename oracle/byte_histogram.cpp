@@ -0,0 +1,147 @@
+#include "byte_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace entropy {
+
+namespace {
+
+// Bytes counted into the 32-bit sub-histograms before folding into 64-bit counts
+constexpr size_t kChunkBytes = size_t(1) << 30;
+
+// Pushes between recomputing sum(c log2 c) from the counts, so rounding
+// error from the running updates cannot build up over long streams
+constexpr uint64_t kResyncPushes = uint64_t(1) << 16;
+
+using SubHistograms = uint32_t[kHistogramTables][256];
+
+// Eight bytes of one little-endian word, one per sub-histogram
+inline void countWord(uint64_t w, SubHistograms& t) {
+    ++t[0][w & 0xff];
+    ++t[1][(w >> 8) & 0xff];
+    ++t[2][(w >> 16) & 0xff];
+    ++t[3][(w >> 24) & 0xff];
+    ++t[4][(w >> 32) & 0xff];
+    ++t[5][(w >> 40) & 0xff];
+    ++t[6][(w >> 48) & 0xff];
+    ++t[7][w >> 56];
+}
+
+void countChunk(const uint8_t* data, size_t n, ByteCounts& counts) {
+    alignas(64) SubHistograms t;
+    std::memset(t, 0, sizeof(t));
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // 32 bytes per step. A run of one repeated byte (zero padding, constant
+    // fields) is the worst case for the tables, so a block that is all one
+    // byte is detected with a compare and counted with a single add.
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i first = _mm256_broadcastb_epi8(_mm256_castsi256_si128(v));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, first)) == -1) {
+            t[0][data[i]] += 32;
+            continue;
+        }
+        countWord(static_cast<uint64_t>(_mm256_extract_epi64(v, 0)), t);
+        countWord(static_cast<uint64_t>(_mm256_extract_epi64(v, 1)), t);
+        countWord(static_cast<uint64_t>(_mm256_extract_epi64(v, 2)), t);
+        countWord(static_cast<uint64_t>(_mm256_extract_epi64(v, 3)), t);
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, sizeof(w));
+        countWord(w, t);
+    }
+    for (; i < n; ++i) ++t[0][data[i]];
+
+    for (size_t b = 0; b < 256; ++b) {
+        uint64_t sum = 0;
+        for (size_t k = 0; k < kHistogramTables; ++k) sum += t[k][b];
+        counts[b] += sum;
+    }
+}
+
+} // namespace
+
+void byte_histogram(const uint8_t* data, size_t n, ByteCounts& counts) {
+    for (size_t begin = 0; begin < n; begin += kChunkBytes)
+        countChunk(data + begin, std::min(kChunkBytes, n - begin), counts);
+}
+
+double histogram_entropy(const ByteCounts& counts, uint64_t total) {
+    if (total == 0) return 0.0;
+    double entropy = 0.0;
+    for (uint64_t c : counts) {
+        if (c == 0) continue;
+        double p = static_cast<double>(c) / total;
+        entropy -= p * std::log2(p);
+    }
+    return entropy;
+}
+
+double buffer_entropy(const uint8_t* data, size_t n) {
+    ByteCounts counts{};
+    byte_histogram(data, n, counts);
+    return histogram_entropy(counts, n);
+}
+
+SlidingEntropy::SlidingEntropy(size_t window)
+    : window(std::max<size_t>(window, 1)), cLogC(this->window + 1, 0.0), ring(this->window, 0) {
+    for (size_t c = 2; c <= this->window; ++c) cLogC[c] = c * std::log2(static_cast<double>(c));
+}
+
+void SlidingEntropy::reset() {
+    filled = head = 0;
+    pushes = 0;
+    sumCLogC = 0.0;
+    counts.fill(0);
+}
+
+void SlidingEntropy::push(uint8_t byte) {
+    if (filled == window) {
+        uint32_t c = counts[ring[head]]--;
+        sumCLogC -= cLogC[c] - cLogC[c - 1];
+    } else {
+        ++filled;
+    }
+    uint32_t c = counts[byte]++;
+    sumCLogC += cLogC[c + 1] - cLogC[c];
+    ring[head] = byte;
+    if (++head == window) head = 0;
+    if (++pushes % kResyncPushes == 0) resync();
+}
+
+void SlidingEntropy::resync() {
+    double sum = 0.0;
+    for (uint32_t c : counts) sum += cLogC[c];
+    sumCLogC = sum;
+}
+
+double SlidingEntropy::value() const {
+    // H = (N log2 N - sum c log2 c) / N
+    if (filled == 0) return 0.0;
+    return std::max(0.0, (cLogC[filled] - sumCLogC) / filled);
+}
+
+void sliding_entropy(const uint8_t* data, size_t n, size_t window, std::vector<double>& out) {
+    out.clear();
+    if (window == 0 || n < window) return;
+    out.reserve(n - window + 1);
+
+    SlidingEntropy s(window);
+    for (size_t i = 0; i < window; ++i) s.push(data[i]);
+    out.push_back(s.value());
+    for (size_t i = window; i < n; ++i) {
+        s.push(data[i]);
+        out.push_back(s.value());
+    }
+}
+
+} // namespace entropy
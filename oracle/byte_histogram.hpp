@@ -0,0 +1,59 @@
+// byte_histogram.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Byte-histogram entropy over large buffers (whole blocks, hash corpora).
+// A single 256-entry histogram stalls on store-to-load forwarding whenever
+// the same byte repeats within a few cycles, so bytes are spread over
+// kHistogramTables interleaved sub-histograms and summed at the end.
+namespace entropy {
+
+constexpr size_t kHistogramTables = 8;
+
+using ByteCounts = std::array<uint64_t, 256>;
+
+// Adds the byte counts of data[0, n) to counts
+void byte_histogram(const uint8_t* data, size_t n, ByteCounts& counts);
+
+// Shannon entropy in bits per byte of a histogram over `total` bytes
+double histogram_entropy(const ByteCounts& counts, uint64_t total);
+
+// byte_histogram() + histogram_entropy(); matches shannonEntropy(data, n)
+double buffer_entropy(const uint8_t* data, size_t n);
+
+// Entropy of the last `window` bytes of a stream, O(1) per byte: pushing a
+// byte moves one count up and, once the window is full, one count down,
+// and sum(c log2 c) is adjusted by table differences.
+class SlidingEntropy {
+public:
+    explicit SlidingEntropy(size_t window);
+
+    void push(uint8_t byte);
+    void reset();
+
+    bool full() const { return filled == window; }
+    size_t size() const { return filled; }
+
+    // Entropy in bits per byte of the bytes currently in the window
+    double value() const;
+
+private:
+    size_t window;
+    size_t filled = 0;
+    size_t head = 0;
+    uint64_t pushes = 0;
+    double sumCLogC = 0.0;          // sum over byte values of c log2 c
+    std::vector<double> cLogC;      // c log2 c for c in [0, window]
+    std::vector<uint8_t> ring;
+    std::array<uint32_t, 256> counts{};
+
+    void resync();
+};
+
+// out[i] = entropy of data[i, i + window), for i in [0, n - window]
+void sliding_entropy(const uint8_t* data, size_t n, size_t window, std::vector<double>& out);
+
+} // namespace entropy
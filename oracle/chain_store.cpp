@@ -0,0 +1,293 @@
+#include "chain_store.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr char kChainMagic[8] = {'O', 'R', 'C', 'L', 'C', 'H', 'N', '1'};
+constexpr uint32_t kChainVersion = 1;
+
+// Segments hashed together, one per hashHeaders() vector lane
+constexpr size_t kSegmentLanes = 8;
+
+struct ChainFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t segmentSize;
+    uint64_t count;
+    uint64_t segments;
+    uint64_t varintBytes;
+    uint32_t startHeight;
+    uint32_t reserved;
+    uint8_t tipHash[32];  // hash of the last header, internal byte order
+};
+static_assert(sizeof(ChainFileHeader) == 80, "ChainFileHeader layout is part of the file format");
+
+struct Checkpoint {
+    uint8_t prevHash[32];  // prevBlockHash of the segment's first header
+    uint32_t version;      // version, time and bits of the first header
+    uint32_t timestamp;
+    uint32_t bits;
+    uint32_t versionBytes;  // varint stream lengths for the rest of the segment
+    uint32_t timeBytes;
+    uint32_t bitsBytes;
+    uint64_t offset;  // start of the segment's streams in the varint section
+};
+static_assert(sizeof(Checkpoint) == 64, "Checkpoint layout is part of the file format");
+
+// Layout: file header, checkpoints, merkle roots (32 bytes each), nonces
+// (4 bytes each), then every segment's version, time and bits varint streams
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+inline void storeLE32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+// Checkpoints are 64 bytes after an 80-byte header in a page-aligned mapping
+inline const Checkpoint& checkpointAt(const uint8_t* table, size_t seg) {
+    return reinterpret_cast<const Checkpoint*>(table)[seg];
+}
+
+// Zigzag varint of the wrapping difference cur - prev
+void putDelta(std::vector<uint8_t>& out, uint32_t prev, uint32_t cur) {
+    int32_t d = static_cast<int32_t>(cur - prev);
+    uint32_t z = (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);
+    while (z >= 0x80) {
+        out.push_back(static_cast<uint8_t>(z | 0x80));
+        z >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(z));
+}
+
+inline bool getDelta(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+    uint32_t z = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        uint8_t b = *p++;
+        z |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            value += (z >> 1) ^ (0u - (z & 1));
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool writeChainStore(const std::string& path, std::span<const Header80> chain, uint32_t startHeight,
+                     uint32_t segmentSize) {
+    if (segmentSize == 0) return false;
+
+    std::vector<Hash256> hashes(chain.size());
+    hashHeaders(chain, hashes);
+    for (size_t i = 1; i < chain.size(); ++i) {
+        if (std::memcmp(chain[i].bytes + 4, hashes[i - 1].data(), 32) != 0) {
+            std::cerr << "[ERROR] Header " << i << " does not extend header " << i - 1 << std::endl;
+            return false;
+        }
+    }
+
+    const size_t segments = (chain.size() + segmentSize - 1) / segmentSize;
+    std::vector<Checkpoint> checkpoints(segments);
+    std::vector<uint8_t> varints, stream;
+    for (size_t s = 0; s < segments; ++s) {
+        size_t begin = s * segmentSize, end = std::min(chain.size(), begin + segmentSize);
+        const uint8_t* first = chain[begin].bytes;
+        Checkpoint& cp = checkpoints[s];
+        std::memcpy(cp.prevHash, first + 4, 32);
+        cp.version = loadLE32(first);
+        cp.timestamp = loadLE32(first + 68);
+        cp.bits = loadLE32(first + 72);
+        cp.offset = varints.size();
+
+        // One stream per field: version at byte 0, time at 68, bits at 72
+        uint32_t* lengths[] = {&cp.versionBytes, &cp.timeBytes, &cp.bitsBytes};
+        const size_t fieldOffsets[] = {0, 68, 72};
+        for (size_t f = 0; f < 3; ++f) {
+            stream.clear();
+            for (size_t i = begin + 1; i < end; ++i)
+                putDelta(stream, loadLE32(chain[i - 1].bytes + fieldOffsets[f]), loadLE32(chain[i].bytes + fieldOffsets[f]));
+            *lengths[f] = static_cast<uint32_t>(stream.size());
+            varints.insert(varints.end(), stream.begin(), stream.end());
+        }
+    }
+
+    std::vector<uint8_t> merkleRoots(chain.size() * 32), nonces(chain.size() * 4);
+    for (size_t i = 0; i < chain.size(); ++i) {
+        std::memcpy(&merkleRoots[i * 32], chain[i].bytes + 36, 32);
+        std::memcpy(&nonces[i * 4], chain[i].bytes + 76, 4);
+    }
+
+    ChainFileHeader h{};
+    std::memcpy(h.magic, kChainMagic, sizeof(kChainMagic));
+    h.version = kChainVersion;
+    h.segmentSize = segmentSize;
+    h.count = chain.size();
+    h.segments = segments;
+    h.varintBytes = varints.size();
+    h.startHeight = startHeight;
+    if (!hashes.empty()) std::memcpy(h.tipHash, hashes.back().data(), 32);
+
+    // Written beside the target and renamed over it, so a reader never maps half a store
+    std::string tmpPath = path + ".tmp";
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(checkpoints.data(), sizeof(Checkpoint), segments, f) == segments &&
+              std::fwrite(merkleRoots.data(), 1, merkleRoots.size(), f) == merkleRoots.size() &&
+              std::fwrite(nonces.data(), 1, nonces.size(), f) == nonces.size() &&
+              std::fwrite(varints.data(), 1, varints.size(), f) == varints.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ChainStore::open(const std::string& path) {
+    count = segments = varintBytes = 0;
+    if (!file.open(path)) return false;
+
+    ChainFileHeader h{};
+    bool ok = file.size() >= sizeof(h);
+    if (ok) {
+        std::memcpy(&h, file.data(), sizeof(h));
+        ok = std::memcmp(h.magic, kChainMagic, sizeof(kChainMagic)) == 0 && h.version == kChainVersion &&
+             h.segmentSize > 0 && h.segments == (h.count + h.segmentSize - 1) / h.segmentSize &&
+             h.count <= file.size() / 36 &&
+             file.size() == sizeof(h) + h.segments * sizeof(Checkpoint) + h.count * 36 + h.varintBytes;
+    }
+    if (!ok) {
+        std::cerr << "[ERROR] Corrupt chain store: " << path << std::endl;
+        file.close();
+        return false;
+    }
+
+    count = h.count;
+    segments = h.segments;
+    segment = h.segmentSize;
+    firstHeight = h.startHeight;
+    std::memcpy(tip.data(), h.tipHash, 32);
+    checkpointTable = file.data() + sizeof(h);
+    merkleRoots = file.data() + sizeof(h) + segments * sizeof(Checkpoint);
+    nonces = merkleRoots + count * 32;
+    varints = nonces + count * 4;
+    varintBytes = h.varintBytes;
+    return true;
+}
+
+bool ChainStore::decodeFields(size_t seg, Header80* out) const {
+    const Checkpoint& cp = checkpointAt(checkpointTable, seg);
+    const size_t begin = seg * segment, n = std::min<size_t>(segment, count - begin);
+    uint64_t streamBytes = uint64_t(cp.versionBytes) + cp.timeBytes + cp.bitsBytes;
+    if (cp.offset > varintBytes || streamBytes > varintBytes - cp.offset) return false;
+
+    const uint8_t* vp = varints + cp.offset;
+    const uint8_t* tp = vp + cp.versionBytes;
+    const uint8_t* bp = tp + cp.timeBytes;
+    const uint8_t* const vEnd = tp;
+    const uint8_t* const tEnd = bp;
+    const uint8_t* const bEnd = bp + cp.bitsBytes;
+
+    uint32_t version = cp.version, timestamp = cp.timestamp, bits = cp.bits;
+    std::memcpy(out[0].bytes + 4, cp.prevHash, 32);
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && !(getDelta(vp, vEnd, version) && getDelta(tp, tEnd, timestamp) && getDelta(bp, bEnd, bits)))
+            return false;
+        uint8_t* h = out[i].bytes;
+        storeLE32(h, version);
+        std::memcpy(h + 36, merkleRoots + (begin + i) * 32, 32);
+        storeLE32(h + 68, timestamp);
+        storeLE32(h + 72, bits);
+        std::memcpy(h + 76, nonces + (begin + i) * 4, 4);
+    }
+    return vp == vEnd && tp == tEnd && bp == bEnd;
+}
+
+bool ChainStore::decode(size_t first, size_t n, Header80* out) const {
+    if (first > count || n > count - first) return false;
+    if (n == 0) return true;
+
+    const size_t firstSeg = first / segment, lastSeg = (first + n - 1) / segment;
+    const size_t groups = (lastSeg - firstSeg) / kSegmentLanes + 1;
+    std::atomic<bool> ok{true};
+
+    parallelFor(groups, [&](size_t gBegin, size_t gEnd) {
+        std::vector<Header80> scratch(std::min(kSegmentLanes, lastSeg + 1 - firstSeg) * segment);
+        Header80 batch[kSegmentLanes];
+        Hash256 hashes[kSegmentLanes];
+        size_t laneSeg[kSegmentLanes], laneLen[kSegmentLanes], laneHashes[kSegmentLanes], laneOf[kSegmentLanes];
+
+        for (size_t g = gBegin; g < gEnd && ok; ++g) {
+            size_t segBegin = firstSeg + g * kSegmentLanes;
+            size_t lanes = std::min(kSegmentLanes, lastSeg + 1 - segBegin);
+            size_t longest = 0;
+            for (size_t l = 0; l < lanes; ++l) {
+                laneSeg[l] = segBegin + l;
+                laneLen[l] = std::min<size_t>(segment, count - laneSeg[l] * segment);
+                // Headers up to the end of the range need their predecessors'
+                // hashes; a segment decoded to its end also hashes its last
+                // header to verify it
+                size_t need = std::min(laneLen[l], first + n - laneSeg[l] * segment);
+                laneHashes[l] = need == laneLen[l] ? need : need - 1;
+                longest = std::max(longest, laneHashes[l]);
+                if (!decodeFields(laneSeg[l], &scratch[l * segment])) ok = false;
+            }
+            if (!ok) return;
+
+            // Step j hashes header j of every segment; its hash is header j + 1's prevBlockHash
+            for (size_t j = 0; j < longest; ++j) {
+                size_t active = 0;
+                for (size_t l = 0; l < lanes; ++l) {
+                    if (j >= laneHashes[l]) continue;
+                    batch[active] = scratch[l * segment + j];
+                    laneOf[active++] = l;
+                }
+                if (active == 0) break;
+                // A lone segment (a short read) is a serial chain: the vector path would waste 7 of 8 lanes
+                if (active == 1) hashHeader(batch[0], hashes[0]);
+                else hashHeaders(std::span<const Header80>(batch, active), std::span<Hash256>(hashes, active));
+                for (size_t a = 0; a < active; ++a) {
+                    size_t l = laneOf[a];
+                    if (j + 1 < laneLen[l]) {
+                        std::memcpy(scratch[l * segment + j + 1].bytes + 4, hashes[a].data(), 32);
+                        continue;
+                    }
+                    // Last header of the segment: its hash must match what follows
+                    const uint8_t* expected =
+                        laneSeg[l] + 1 < segments ? checkpointAt(checkpointTable, laneSeg[l] + 1).prevHash : tip.data();
+                    if (std::memcmp(hashes[a].data(), expected, 32) != 0) ok = false;
+                }
+            }
+            if (!ok) return;
+
+            for (size_t l = 0; l < lanes; ++l) {
+                size_t segFirst = laneSeg[l] * segment;
+                size_t from = std::max(first, segFirst), to = std::min(first + n, segFirst + laneLen[l]);
+                std::copy(&scratch[l * segment + (from - segFirst)], &scratch[l * segment + (to - segFirst)],
+                          out + (from - first));
+            }
+        }
+    }, 1);
+
+    if (!ok) std::cerr << "[ERROR] Chain store failed verification decoding headers " << first << ".." << first + n - 1
+                       << std::endl;
+    return ok;
+}
+
+bool ChainStore::decodeAll(std::vector<Header80>& out) const {
+    out.resize(count);
+    return decode(0, count, out.data());
+}
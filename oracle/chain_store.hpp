@@ -0,0 +1,63 @@
+// chain_store.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "midstate_batch.hpp"
+
+// Compact columnar store for a chain of headers (oracle/headers.chain). A
+// header's prevBlockHash is the hash of the header before it, so it is not
+// stored; decoding recomputes it. Version, time and bits are zigzag varint
+// deltas against the previous header. Merkle roots and nonces are stored raw,
+// each in its own column.
+//
+// Headers are cut into segments of segmentSize. Each segment starts at a
+// checkpoint holding the full prevBlockHash, version, time and bits of its
+// first header. Segments therefore decode independently, which gives random
+// access and lets 8 segments share one batched SHA-256 call. The checkpoint
+// after a segment, or the tip hash for the last one, verifies the hashes
+// recomputed for a segment decoded to its end. BlockHeader::fromBytes() turns decoded
+// headers into BlockHeader.
+
+constexpr uint32_t kChainSegmentSize = 256;
+
+// Writes a chain store. chain must be linked: every header's prevBlockHash is
+// the hash of the one before it. startHeight is the height of chain[0].
+bool writeChainStore(const std::string& path, std::span<const Header80> chain, uint32_t startHeight,
+                     uint32_t segmentSize = kChainSegmentSize);
+
+class ChainStore {
+public:
+    bool open(const std::string& path);
+
+    size_t size() const { return count; }
+    uint32_t startHeight() const { return firstHeight; }
+    uint32_t segmentSize() const { return segment; }
+    const Hash256& tipHash() const { return tip; }
+
+    // Decodes headers [first, first + n) into out, starting from the
+    // checkpoint at or before first, so a single header costs up to
+    // segmentSize - 1 extra hashes. Returns false if the range is out of
+    // bounds or the store is corrupt.
+    bool decode(size_t first, size_t n, Header80* out) const;
+    bool decodeAll(std::vector<Header80>& out) const;
+
+private:
+    // Header bytes of one segment, with prevBlockHash set only on its first header
+    bool decodeFields(size_t seg, Header80* out) const;
+
+    MappedFile file;
+    size_t count = 0;
+    size_t segments = 0;
+    uint32_t segment = kChainSegmentSize;
+    uint32_t firstHeight = 0;
+    Hash256 tip{};
+    const uint8_t* checkpointTable = nullptr;
+    const uint8_t* merkleRoots = nullptr;
+    const uint8_t* nonces = nullptr;
+    const uint8_t* varints = nullptr;
+    size_t varintBytes = 0;
+};
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "hamming_pairs.hpp"
+#include "midstate_clusters.hpp"
+#include "npy_writer.hpp"
+#include "oracle_store.hpp"
+#include "oracle_utils.hpp"
+
+// All-pairs Hamming distances and single-linkage clusters over store rows:
+//
+//   cluster_midstates [--store oracle/midstates.bin] [--rows N] [--field midstate|blockhash]
+//                     [--threshold 64] [--out oracle/midstate_clusters.bin] [--matrix dist.npy]
+//
+// Rows closer than or equal to --threshold bits end up in the same cluster.
+// --rows takes the last N store rows (all pairs is quadratic). --matrix also
+// streams the condensed upper-triangle distances (uint16, scipy pdist order).
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string outPath = "oracle/midstate_clusters.bin";
+    std::string matrixPath;
+    std::string field = "midstate";
+    size_t rowLimit = 0;
+    uint32_t threshold = 64;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--matrix") matrixPath = argv[i + 1];
+        else if (arg == "--field") field = argv[i + 1];
+        else if (arg == "--rows") rowLimit = std::stoul(argv[i + 1]);
+        else if (arg == "--threshold") threshold = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (field != "midstate" && field != "blockhash") {
+        std::cerr << "❌ --field must be midstate or blockhash\n";
+        return 1;
+    }
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    size_t n = rowLimit ? std::min(rowLimit, store.size()) : store.size();
+    size_t firstRow = store.size() - n;
+    if (n < 2) {
+        std::cerr << "❌ Error: need at least 2 rows, have " << n << "\n";
+        return 1;
+    }
+    if (n > 200000)
+        std::cout << "⚠️ " << n << " rows means " << n * (n - 1) / 2 << " pairs; consider --rows\n";
+
+    std::vector<uint8_t> codes(n * 32);
+    for (size_t i = 0; i < n; ++i) {
+        const StoreRecord& rec = store[firstRow + i];
+        const uint8_t* src = field == "midstate" ? rec.midstate : rec.blockhash;
+        std::copy(src, src + 32, &codes[i * 32]);
+    }
+
+    NpyWriter matrix;
+    if (!matrixPath.empty() && !matrix.open(matrixPath, "<u2", 0, sizeof(uint16_t))) {
+        std::cerr << "❌ Error: Could not write to " << matrixPath << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    DisjointSets sets(n);
+    uint64_t histogram[257] = {};
+    uint64_t linked = 0;
+    bool matrixOk = true;
+
+    forEachDistanceBand(codes.data(), n, [&](const DistanceBand& band) {
+        for (size_t r = 0; r < band.rows; ++r) {
+            std::span<const uint16_t> row = band.upper(r);
+            uint32_t i = static_cast<uint32_t>(band.rowBegin + r);
+            for (size_t j = 0; j < row.size(); ++j) {
+                ++histogram[row[j]];
+                if (row[j] <= threshold && sets.unite(i, static_cast<uint32_t>(i + 1 + j))) ++linked;
+            }
+            if (!matrixPath.empty() && matrixOk) matrixOk = matrix.append(row.data(), row.size());
+        }
+    });
+    std::cout << "📏 " << n * (n - 1) / 2 << " pairs over " << n << " " << field << " rows [" << msSince(start) << " ms]\n";
+
+    if (!matrixPath.empty()) {
+        if (!matrixOk || !matrix.commit()) {
+            std::cerr << "❌ Error: Could not write to " << matrixPath << "\n";
+            return 1;
+        }
+        std::cout << "✅ Saved distance matrix to " << matrixPath << "\n";
+    }
+
+    ClusterAssignment assignment;
+    assignment.firstRow = firstRow;
+    assignment.threshold = threshold;
+    assignment.field = field == "midstate" ? 0 : 1;
+    assignment.clusters = sets.labels(assignment.cluster);
+
+    // Distance profile: closest pair and pairs within the cut
+    uint32_t minDistance = 0;
+    while (minDistance < 256 && histogram[minDistance] == 0) ++minDistance;
+    uint64_t within = 0;
+    for (uint32_t d = 0; d <= std::min(threshold, 256u); ++d) within += histogram[d];
+    std::cout << "📊 Closest pair " << minDistance << " bits, " << within << " pairs within " << threshold
+              << " bits, " << linked << " merges\n";
+
+    std::vector<uint32_t> sizes(assignment.clusters, 0);
+    for (uint32_t c : assignment.cluster) ++sizes[c];
+    std::sort(sizes.begin(), sizes.end(), std::greater<>());
+    std::cout << "🧩 " << assignment.clusters << " clusters, largest:";
+    for (size_t c = 0; c < std::min<size_t>(5, sizes.size()); ++c) std::cout << " " << sizes[c];
+    std::cout << "\n";
+
+    if (!saveClusters(outPath, assignment)) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "✅ Saved cluster assignments to " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include "cnn_oracle.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Lane helpers are internal; the by-value vector ABI note does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace {
+
+// One sample per lane: 8 with AVX, 4 with SSE or NEON, so a tile of
+// accumulators fits the register file
+#if defined(__AVX__)
+typedef float f32xN __attribute__((vector_size(32)));
+#else
+typedef float f32xN __attribute__((vector_size(16)));
+#endif
+constexpr size_t kLanes = sizeof(f32xN) / sizeof(float);
+
+// Groups per thread chunk
+constexpr size_t kMinGroups = 16;
+
+// Outputs accumulated in registers at once
+constexpr size_t kTile = 8;
+
+constexpr char kWeightsMagic[8] = {'C', 'N', 'N', 'O', 'R', 'C', 'L', '1'};
+constexpr uint32_t kWeightsVersion = 1;
+
+struct WeightsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t inputLength;
+    uint32_t conv1Channels;
+    uint32_t conv2Channels;
+    uint32_t hidden;
+    uint32_t kernel;
+};
+
+inline f32xN relu(f32xN v) {
+    f32xN zero = {};
+    return v > zero ? v : zero;
+}
+
+// out[t] = relu(bias + sum over channels i and taps k of w[i][k] * in[i][t + k]),
+// where in holds `channels` zero-padded rows of `stride` lanes. Outputs go
+// kTile at a time with their sums in registers.
+void convRow(const f32xN* in, size_t stride, size_t channels, const float* w, size_t K,
+             float bias, size_t L, f32xN* out) {
+    size_t t0 = 0;
+    for (; t0 + kTile <= L; t0 += kTile) {
+        f32xN acc[kTile];
+        for (size_t t = 0; t < kTile; ++t) acc[t] = f32xN{} + bias;
+        for (size_t i = 0; i < channels; ++i) {
+            const f32xN* row = in + i * stride + t0;
+            for (size_t k = 0; k < K; ++k) {
+                float wk = w[i * K + k];
+#pragma GCC unroll 8
+                for (size_t t = 0; t < kTile; ++t) acc[t] += wk * row[t + k];
+            }
+        }
+        for (size_t t = 0; t < kTile; ++t) out[t0 + t] = relu(acc[t]);
+    }
+    for (; t0 < L; ++t0) {
+        f32xN acc = f32xN{} + bias;
+        for (size_t i = 0; i < channels; ++i)
+            for (size_t k = 0; k < K; ++k) acc += w[i * K + k] * in[i * stride + t0 + k];
+        out[t0] = relu(acc);
+    }
+}
+
+bool readFloats(FILE* f, std::vector<float>& out, size_t n) {
+    out.resize(n);
+    return std::fread(out.data(), sizeof(float), n, f) == n;
+}
+
+} // namespace
+
+void encodeCnnInput(const uint8_t* midstate, const uint8_t* tail, float* out) {
+    for (size_t i = 0; i < 32; ++i) out[i] = midstate[i] / 255.0f;
+    for (size_t i = 0; i < 16; ++i) out[32 + i] = tail[i] / 255.0f;
+}
+
+bool CnnOracle::load(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cerr << "[ERROR] Cannot open CNN weights: " << path << std::endl;
+        return false;
+    }
+
+    WeightsHeader h{};
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 &&
+              std::memcmp(h.magic, kWeightsMagic, sizeof(kWeightsMagic)) == 0 &&
+              h.version == kWeightsVersion && h.kernel % 2 == 1 &&
+              h.inputLength && h.conv1Channels && h.conv2Channels && h.hidden;
+
+    std::vector<float> fc1Weight, fc2WeightRow, fc2BiasRow;
+    if (ok) {
+        length = h.inputLength;
+        kernel = h.kernel;
+        conv1Channels = h.conv1Channels;
+        conv2Channels = h.conv2Channels;
+        hidden = h.hidden;
+        size_t flat = conv2Channels * length;
+        ok = readFloats(f, conv1Weight, conv1Channels * kernel) &&
+             readFloats(f, conv1Bias, conv1Channels) &&
+             readFloats(f, conv2Weight, conv2Channels * conv1Channels * kernel) &&
+             readFloats(f, conv2Bias, conv2Channels) &&
+             readFloats(f, fc1Weight, hidden * flat) &&
+             readFloats(f, fc1Bias, hidden) &&
+             readFloats(f, fc2WeightRow, hidden) &&
+             readFloats(f, fc2BiasRow, 1);
+    }
+    std::fclose(f);
+
+    if (!ok) {
+        std::cerr << "[ERROR] Corrupt CNN weights: " << path << std::endl;
+        length = 0;
+        return false;
+    }
+
+    // Input-major fc1 so each flattened activation updates a tile of hidden
+    // units; hidden is padded to whole tiles with zero units
+    size_t flat = conv2Channels * length;
+    size_t paddedHidden = (hidden + kTile - 1) / kTile * kTile;
+    fc1WeightT.assign(flat * paddedHidden, 0.0f);
+    for (size_t j = 0; j < hidden; ++j)
+        for (size_t i = 0; i < flat; ++i) fc1WeightT[i * paddedHidden + j] = fc1Weight[j * flat + i];
+    fc1Bias.resize(paddedHidden, 0.0f);
+    fc2Weight = std::move(fc2WeightRow);
+    fc2Weight.resize(paddedHidden, 0.0f);
+    fc2Bias = fc2BiasRow[0];
+    return true;
+}
+
+// load(sample, lanes, x) fills x[t][lane] for the group starting at `sample`
+template <typename Load>
+void CnnOracle::run(size_t count, float* out, Load&& load) const {
+    const size_t L = length, K = kernel, pad = kernel / 2, P = length + 2 * pad;
+    const size_t C1 = conv1Channels, C2 = conv2Channels, H = fc1Bias.size();
+    size_t groups = (count + kLanes - 1) / kLanes;
+
+    parallelFor(groups, [&](size_t begin, size_t end) {
+        // Conv inputs keep `pad` zero lanes on each side, so taps need no bounds checks
+        std::vector<f32xN> x(P), a1(C1 * P), a2(C2 * L), h(H);
+
+        for (size_t g = begin; g < end; ++g) {
+            size_t base = g * kLanes;
+            size_t lanes = std::min(kLanes, count - base);
+            std::fill(x.begin(), x.end(), f32xN{});
+            load(base, lanes, x.data() + pad);
+
+            for (size_t c = 0; c < C1; ++c)
+                convRow(x.data(), P, 1, &conv1Weight[c * K], K, conv1Bias[c], L, &a1[c * P + pad]);
+            for (size_t o = 0; o < C2; ++o)
+                convRow(a1.data(), P, C1, &conv2Weight[o * C1 * K], K, conv2Bias[o], L, &a2[o * L]);
+
+            // Flatten + Linear(C2*L -> H); a2 is already in PyTorch's [channel][t] order.
+            // Hidden units go kTile at a time with their sums in registers.
+            for (size_t j0 = 0; j0 < H; j0 += kTile) {
+                f32xN acc[kTile];
+                for (size_t j = 0; j < kTile; ++j) acc[j] = f32xN{} + fc1Bias[j0 + j];
+                for (size_t i = 0; i < C2 * L; ++i) {
+                    const float* w = &fc1WeightT[i * H + j0];
+                    f32xN a = a2[i];
+#pragma GCC unroll 8
+                    for (size_t j = 0; j < kTile; ++j) acc[j] += w[j] * a;
+                }
+                for (size_t j = 0; j < kTile; ++j) h[j0 + j] = relu(acc[j]);
+            }
+
+            // Linear(H -> 1) + Sigmoid
+            f32xN z = f32xN{} + fc2Bias;
+            for (size_t j = 0; j < H; ++j) z += fc2Weight[j] * h[j];
+            for (size_t l = 0; l < lanes; ++l) out[base + l] = 1.0f / (1.0f + std::exp(-z[l]));
+        }
+    }, kMinGroups);
+}
+
+void CnnOracle::predict(const float* inputs, size_t count, float* out) const {
+    const size_t L = length;
+    run(count, out, [&](size_t base, size_t lanes, f32xN* x) {
+        for (size_t l = 0; l < lanes; ++l) {
+            const float* row = inputs + (base + l) * L;
+            for (size_t t = 0; t < L; ++t) x[t][l] = row[t];
+        }
+    });
+}
+
+void CnnOracle::predict(const StoreRecord* records, size_t count, float* out) const {
+    if (length != kCnnInputLength) {
+        std::cerr << "[ERROR] CNN input length " << length << " does not match midstate + tail ("
+                  << kCnnInputLength << ")" << std::endl;
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    run(count, out, [&](size_t base, size_t lanes, f32xN* x) {
+        float row[kCnnInputLength];
+        for (size_t l = 0; l < lanes; ++l) {
+            encodeCnnInput(records[base + l].midstate, records[base + l].tail, row);
+            for (size_t t = 0; t < kCnnInputLength; ++t) x[t][l] = row[t];
+        }
+    });
+}
@@ -0,0 +1,47 @@
+// cnn_oracle.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "oracle_store.hpp"
+
+// Native inference for CNNOracle (cnn_oracle_model.py):
+// Conv1d(1->C1, k) -> ReLU -> Conv1d(C1->C2, k) -> ReLU -> Linear(C2*L->H) -> ReLU -> Linear(H->1) -> Sigmoid
+//
+// Weights come from export_cnn_weights.py. Samples are processed one per
+// vector lane (8 with AVX, 4 with SSE/NEON), so every layer is a broadcast
+// multiply-add over lanes; groups are spread across threads.
+
+// Model input for one candidate: midstate then tail bytes, each byte / 255
+constexpr size_t kCnnInputLength = 48;
+void encodeCnnInput(const uint8_t* midstate, const uint8_t* tail, float* out);
+
+class CnnOracle {
+public:
+    bool load(const std::string& path);
+
+    size_t inputLength() const { return length; }
+
+    // inputs holds count rows of inputLength() floats; writes count scores
+    void predict(const float* inputs, size_t count, float* out) const;
+
+    // Scores store records directly from their midstate and tail
+    void predict(const StoreRecord* records, size_t count, float* out) const;
+
+private:
+    template <typename Load>
+    void run(size_t count, float* out, Load&& load) const;
+
+    size_t length = 0;
+    size_t kernel = 0;
+    size_t conv1Channels = 0;
+    size_t conv2Channels = 0;
+    size_t hidden = 0;
+
+    std::vector<float> conv1Weight, conv1Bias;  // [C1][k], [C1]
+    std::vector<float> conv2Weight, conv2Bias;  // [C2][C1][k], [C2]
+    std::vector<float> fc1WeightT, fc1Bias;     // transposed to [C2*L][H], [H], H padded to whole tiles
+    std::vector<float> fc2Weight;               // [H], padded like fc1Bias
+    float fc2Bias = 0.0f;
+};
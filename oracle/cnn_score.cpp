@@ -0,0 +1,108 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include "../hex_codec.hpp"
+#include "cnn_oracle.hpp"
+#include "oracle_store.hpp"
+#include "oracle_utils.hpp"
+
+// Scores every midstate in the store with the native CNNOracle engine:
+//
+//   cnn_score [--weights oracle/cnn_oracle.bin] [--store oracle/midstates.bin] [--top 10]
+//   cnn_score --check oracle/cnn_oracle_check.bin [--weights oracle/cnn_oracle.bin]
+//
+// --check compares against the PyTorch predictions written by export_cnn_weights.py.
+
+int runCheck(const CnnOracle& model, const std::string& checkPath) {
+    FILE* f = std::fopen(checkPath.c_str(), "rb");
+    if (!f) {
+        std::cerr << "❌ Error: " << checkPath << " not found.\n";
+        return 1;
+    }
+    uint32_t dims[2] = {};
+    std::vector<float> inputs, expected;
+    bool ok = std::fread(dims, sizeof(dims), 1, f) == 1 && dims[1] == model.inputLength();
+    if (ok) {
+        inputs.resize(size_t(dims[0]) * dims[1]);
+        expected.resize(dims[0]);
+        ok = std::fread(inputs.data(), sizeof(float), inputs.size(), f) == inputs.size() &&
+             std::fread(expected.data(), sizeof(float), expected.size(), f) == expected.size();
+    }
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << "❌ Error: " << checkPath << " is malformed or does not match the model.\n";
+        return 1;
+    }
+
+    std::vector<float> got(expected.size());
+    model.predict(inputs.data(), got.size(), got.data());
+
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < got.size(); ++i) maxDiff = std::max(maxDiff, std::fabs(double(got[i]) - expected[i]));
+
+    std::cout << "🔍 " << got.size() << " samples, max |native - PyTorch| = " << maxDiff << "\n";
+    if (maxDiff > 1e-5) {
+        std::cerr << "❌ Native inference differs from PyTorch by more than 1e-5\n";
+        return 1;
+    }
+    std::cout << "✅ Native inference matches PyTorch\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string weightsPath = "oracle/cnn_oracle.bin";
+    std::string storePath = "oracle/midstates.bin";
+    std::string checkPath;
+    size_t topK = 10;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--weights") weightsPath = argv[i + 1];
+        else if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--check") checkPath = argv[i + 1];
+        else if (arg == "--top") topK = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    CnnOracle model;
+    if (!model.load(weightsPath)) {
+        std::cerr << "❌ Error: run export_cnn_weights.py to create " << weightsPath << "\n";
+        return 1;
+    }
+
+    if (!checkPath.empty()) return runCheck(model, checkPath);
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<float> scores(store.size());
+    model.predict(store.data(), store.size(), scores.data());
+    double ms = msSince(start);
+    std::cout << "🧠 Scored " << scores.size() << " midstates [" << ms << " ms, "
+              << (ms > 0 ? scores.size() / ms * 1000.0 : 0.0) << " /s]\n";
+
+    std::vector<size_t> order(scores.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    topK = std::min(topK, order.size());
+    std::partial_sort(order.begin(), order.begin() + topK, order.end(),
+                      [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+
+    for (size_t i = 0; i < topK; ++i) {
+        const StoreRecord& rec = store[order[i]];
+        std::cout << "[" << i + 1 << "] " << hexEncode(rec.blockhash, 32) << " | height " << rec.height
+                  << " | cnn: " << scores[order[i]] << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "entropy_batch.hpp"
+#include "entropy_tables.hpp"
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace entropy {
+
+namespace {
+
+inline uint32_t popcount32Bytes(const uint8_t* p) {
+    uint64_t w[4];
+    std::memcpy(w, p, sizeof(w));
+    return __builtin_popcountll(w[0]) + __builtin_popcountll(w[1]) +
+           __builtin_popcountll(w[2]) + __builtin_popcountll(w[3]);
+}
+
+} // namespace
+
+double bit_entropy(size_t ones, size_t total) {
+    if (total == 0) return 0.0;
+    size_t zeros = total - ones;
+    double p0 = static_cast<double>(zeros) / total;
+    double p1 = static_cast<double>(ones) / total;
+
+    double e = 0.0;
+    if (p0 > 0.0) e -= p0 * std::log2(p0);
+    if (p1 > 0.0) e -= p1 * std::log2(p1);
+    return e;
+}
+
+void popcount_blocks(const uint8_t* blocks, size_t count, uint32_t* onesOut) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    // Nibble-lookup popcount: one 256-bit register per block
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+    for (; i < count; ++i) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks + i * kBlockBytes));
+        __m256i lo = _mm256_and_si256(v, lowMask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        __m256i sums = _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+        onesOut[i] = static_cast<uint32_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                                           _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+    }
+#elif defined(__ARM_NEON)
+    for (; i < count; ++i) {
+        const uint8_t* p = blocks + i * kBlockBytes;
+        uint8x16_t c = vaddq_u8(vcntq_u8(vld1q_u8(p)), vcntq_u8(vld1q_u8(p + 16)));
+        onesOut[i] = vaddlvq_u8(c);
+    }
+#endif
+    for (; i < count; ++i) onesOut[i] = popcount32Bytes(blocks + i * kBlockBytes);
+}
+
+void compute_block_metrics(const uint8_t* blocks, size_t count, BlockMetrics* out) {
+    const auto& table = kBitEntropy<kBlockBits>;
+
+    std::vector<uint32_t> ones(count);
+    popcount_blocks(blocks, count, ones.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t k = ones[i];
+        double base = table[k];
+        // Flipping a set bit moves the popcount to k-1, a clear bit to k+1
+        double dOne = k > 0 ? std::abs(table[k - 1] - base) : 0.0;
+        double dZero = k < kBlockBits ? std::abs(table[k + 1] - base) : 0.0;
+
+        // Accumulate in bit order so the sum rounds exactly like bit_flip_sensitivity()
+        const uint8_t* p = blocks + i * kBlockBytes;
+        double total = 0.0;
+        for (size_t byte = 0; byte < kBlockBytes; ++byte) {
+            for (int b = 7; b >= 0; --b) {
+                total += ((p[byte] >> b) & 1) ? dOne : dZero;
+            }
+        }
+
+        out[i] = {k, base, total};
+    }
+}
+
+std::vector<BlockMetrics> compute_block_metrics(const std::vector<uint8_t>& blocks) {
+    std::vector<BlockMetrics> out(blocks.size() / kBlockBytes);
+    compute_block_metrics(blocks.data(), out.size(), out.data());
+    return out;
+}
+
+void entropy_slope_block(const uint8_t* block, double* slopeOut, bool absolute) {
+    const auto& table = kBitEntropy<kBlockBits>;
+    uint32_t k = popcount32Bytes(block);
+    double base = table[k];
+    double dOne = k > 0 ? table[k - 1] - base : 0.0;
+    double dZero = k < kBlockBits ? table[k + 1] - base : 0.0;
+    if (absolute) {
+        dOne = std::abs(dOne);
+        dZero = std::abs(dZero);
+    }
+
+    for (size_t byte = 0; byte < kBlockBytes; ++byte) {
+        for (int b = 7; b >= 0; --b) {
+            *slopeOut++ = ((block[byte] >> b) & 1) ? dOne : dZero;
+        }
+    }
+}
+
+} // namespace entropy
@@ -0,0 +1,37 @@
+// entropy_batch.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Batch bit-entropy metrics over packed 32-byte midstates.
+// Results match entropy::shannon_entropy(), entropy_slope() and
+// bit_flip_sensitivity() from entropy_metrics.hpp applied to bytes_to_bits(block),
+// without expanding blocks into std::vector<bool>.
+namespace entropy {
+
+constexpr size_t kBlockBytes = 32;
+constexpr size_t kBlockBits = kBlockBytes * 8;
+
+struct BlockMetrics {
+    uint32_t ones;       // set bits in the block
+    double entropy;      // shannon_entropy(bits)
+    double sensitivity;  // bit_flip_sensitivity(bits)
+};
+
+// Shannon entropy of a bit string with `ones` set bits out of `total`.
+// Fixed block sizes should use kBitEntropy<N> from entropy_tables.hpp.
+double bit_entropy(size_t ones, size_t total);
+
+// Popcount of each 32-byte block (SIMD where available)
+void popcount_blocks(const uint8_t* blocks, size_t count, uint32_t* onesOut);
+
+// Entropy and flip sensitivity for `count` consecutive 32-byte blocks
+void compute_block_metrics(const uint8_t* blocks, size_t count, BlockMetrics* out);
+std::vector<BlockMetrics> compute_block_metrics(const std::vector<uint8_t>& blocks);
+
+// Per-bit entropy slope of one block (256 values, MSB-first bit order).
+// absolute = true matches entropy_metrics.hpp, false matches entropy_filter.cpp.
+void entropy_slope_block(const uint8_t* block, double* slopeOut, bool absolute = true);
+
+} // namespace entropy
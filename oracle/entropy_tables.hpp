@@ -0,0 +1,94 @@
+// entropy_tables.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Compile-time entropy tables for fixed-size records. The bit entropy of an
+// N-bit block depends only on its popcount, and the byte-histogram entropy
+// of an N-byte record only on its byte counts, so scoring is a popcount (or
+// one increment per byte) plus table loads, with no log2 at run time.
+namespace entropy {
+
+namespace detail {
+
+// log2 for constant evaluation: binary exponent by exact scaling, then
+// ln(m) = 2 atanh((m - 1) / (m + 1)) for m in [sqrt(1/2), sqrt(2))
+constexpr double log2_constexpr(double x) {
+    long double m = x;
+    int e = 0;
+    while (m >= 1.4142135623730950488L) { m /= 2; ++e; }
+    while (m < 0.70710678118654752440L) { m *= 2; --e; }
+
+    long double t = (m - 1) / (m + 1), t2 = t * t, term = t, sum = 0;
+    for (int k = 1; term != 0 && k < 64; k += 2) {
+        sum += term / k;
+        term *= t2;
+    }
+    return static_cast<double>(e + 2 * sum / 0.69314718055994530942L);
+}
+
+// Same expression as bit_entropy(ones, total) in entropy_batch.cpp
+constexpr double bit_entropy_constexpr(size_t ones, size_t total) {
+    double p0 = static_cast<double>(total - ones) / total;
+    double p1 = static_cast<double>(ones) / total;
+    double e = 0.0;
+    if (p0 > 0.0) e -= p0 * log2_constexpr(p0);
+    if (p1 > 0.0) e -= p1 * log2_constexpr(p1);
+    return e;
+}
+
+template <size_t Bits>
+constexpr std::array<double, Bits + 1> make_bit_entropy_table() {
+    std::array<double, Bits + 1> t{};
+    for (size_t k = 0; k <= Bits; ++k) t[k] = bit_entropy_constexpr(k, Bits);
+    return t;
+}
+
+// H = log2(N) - sum_c c log2(c) / N; step[c] is what one more occurrence of
+// a byte already seen c times adds to sum_c c log2(c) / N
+template <size_t Bytes>
+constexpr std::array<double, Bytes> make_byte_entropy_steps() {
+    std::array<double, Bytes> t{};
+    for (size_t c = 0; c < Bytes; ++c) {
+        double next = (c + 1) * log2_constexpr(static_cast<double>(c + 1));
+        double prev = c ? c * log2_constexpr(static_cast<double>(c)) : 0.0;
+        t[c] = (next - prev) / Bytes;
+    }
+    return t;
+}
+
+} // namespace detail
+
+// kBitEntropy<N>[k]: Shannon entropy of an N-bit block with k set bits
+template <size_t Bits>
+inline constexpr std::array<double, Bits + 1> kBitEntropy = detail::make_bit_entropy_table<Bits>();
+
+template <size_t Bytes>
+inline constexpr std::array<double, Bytes> kByteEntropySteps = detail::make_byte_entropy_steps<Bytes>();
+
+template <size_t Bytes>
+inline constexpr double kLog2Bytes = detail::log2_constexpr(static_cast<double>(Bytes));
+
+// Shannon entropy of the byte histogram of one Bytes-long record, in bits
+// per byte (what shannonEntropy(data, Bytes) returns)
+template <size_t Bytes>
+double byte_entropy(const uint8_t* record) {
+    static_assert(Bytes > 0 && Bytes < 256, "byte counts are kept in uint8_t");
+    uint8_t counts[256];
+    std::memset(counts, 0, sizeof(counts));
+    double sum = 0.0;
+    for (size_t i = 0; i < Bytes; ++i) sum += kByteEntropySteps<Bytes>[counts[record[i]]++];
+    return kLog2Bytes<Bytes> - sum;
+}
+
+// Records the oracle scores: a midstate, and a midstate with its 16-byte tail
+constexpr size_t kMidstateRecordBytes = 32;
+constexpr size_t kTailRecordBytes = 48;
+
+static_assert(kBitEntropy<256>[0] == 0.0 && kBitEntropy<256>[256] == 0.0);
+static_assert(kBitEntropy<256>[128] == 1.0);
+static_assert(kLog2Bytes<32> == 5.0);
+
+} // namespace entropy
@@ -0,0 +1,233 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "cnn_oracle.hpp"
+#include "midstate_stream.hpp"
+#include "npy_writer.hpp"
+#include "oracle_state.hpp"
+#include "oracle_store.hpp"
+#include "oracle_weights.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+// Exports CNN training data as sharded .npy tensors for cnn_oracle_train.py:
+//
+//   export_training [--json oracle/top_midstates.json] [--out oracle/train] [--shard-rows N] [--float]
+//   export_training --store oracle/midstates.bin [--state oracle/oracle_state.bin] [--out oracle/train] ...
+//
+// Each shard is features-NNNNN.npy (rows x 48: midstate then tail, uint8, or
+// float32 scaled by 1/255 with --float) plus labels-NNNNN.npy (float32 oracle
+// score). manifest.json lists the shards. --json labels rows with their
+// "score"; --store labels every real stored midstate with the score
+// oracle_update ranks by (oracle/oracle_weights.json, or the default 0.6/0.4
+// weights), so the dataset is not limited to the top list.
+// Synthetic rows from generate_synthetic have no meaningful label and are skipped.
+
+// Rows buffered between writes
+constexpr size_t kFlushRows = 65536;
+
+std::string shardName(const char* kind, size_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%s-%05zu.npy", kind, index);
+    return name;
+}
+
+// Splits rows into fixed-size shards and records them in the manifest
+class ShardWriter {
+public:
+    ShardWriter(const fs::path& dir, size_t shardRows, bool floatFeatures)
+        : dir(dir), shardRows(shardRows), floatFeatures(floatFeatures) {}
+
+    bool add(const uint8_t* midstate, const uint8_t* tail, float label) {
+        if (floatFeatures) {
+            floatRows.resize(floatRows.size() + kCnnInputLength);
+            encodeCnnInput(midstate, tail, &floatRows[floatRows.size() - kCnnInputLength]);
+        } else {
+            byteRows.insert(byteRows.end(), midstate, midstate + 32);
+            byteRows.insert(byteRows.end(), tail, tail + 16);
+        }
+        labelRows.push_back(label);
+        ++total;
+        if (labelRows.size() == kFlushRows || shardFill + labelRows.size() == shardRows) return flush();
+        return true;
+    }
+
+    bool finish() {
+        if (!flush() || (open && !closeShard())) return false;
+
+        json manifest = {
+            {"input_length", kCnnInputLength},
+            {"features_dtype", floatFeatures ? "float32" : "uint8"},
+            {"rows", total},
+            {"shards", shards}
+        };
+        std::ofstream out(dir / "manifest.json");
+        out << manifest.dump(2);
+        if (!out) return false;
+
+        // Shards left over from a larger previous export
+        std::error_code ec;
+        for (size_t i = shards.size(); fs::exists(dir / shardName("features", i), ec); ++i) {
+            fs::remove(dir / shardName("features", i), ec);
+            fs::remove(dir / shardName("labels", i), ec);
+        }
+        return true;
+    }
+
+    uint64_t rows() const { return total; }
+
+private:
+    bool flush() {
+        if (labelRows.empty()) return true;
+        if (!open) {
+            std::string f = shardName("features", shards.size());
+            bool ok = floatFeatures ? features.open((dir / f).string(), "<f4", kCnnInputLength, sizeof(float))
+                                    : features.open((dir / f).string(), "|u1", kCnnInputLength, 1);
+            if (!ok || !labels.open((dir / shardName("labels", shards.size())).string(), "<f4", 0, sizeof(float)))
+                return false;
+            open = true;
+        }
+
+        bool ok = (floatFeatures ? features.append(floatRows.data(), labelRows.size())
+                                 : features.append(byteRows.data(), labelRows.size())) &&
+                  labels.append(labelRows.data(), labelRows.size());
+        shardFill += labelRows.size();
+        floatRows.clear();
+        byteRows.clear();
+        labelRows.clear();
+        return ok && (shardFill < shardRows || closeShard());
+    }
+
+    bool closeShard() {
+        shards.push_back({
+            {"features", shardName("features", shards.size())},
+            {"labels", shardName("labels", shards.size())},
+            {"rows", shardFill}
+        });
+        open = false;
+        shardFill = 0;
+        return features.commit() && labels.commit();
+    }
+
+    fs::path dir;
+    size_t shardRows;
+    bool floatFeatures;
+
+    NpyWriter features, labels;
+    bool open = false;
+    size_t shardFill = 0;
+    uint64_t total = 0;
+    json shards = json::array();
+
+    std::vector<uint8_t> byteRows;
+    std::vector<float> floatRows;
+    std::vector<float> labelRows;
+};
+
+int main(int argc, char** argv) {
+    std::string jsonPath = "oracle/top_midstates.json";
+    std::string storePath;
+    std::string statePath = "oracle/oracle_state.bin";
+    std::string outDir = "oracle/train";
+    size_t shardRows = 1 << 20;
+    bool floatFeatures = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--store" && hasValue) storePath = argv[++i];
+        else if (arg == "--state" && hasValue) statePath = argv[++i];
+        else if (arg == "--out" && hasValue) outDir = argv[++i];
+        else if (arg == "--shard-rows" && hasValue) shardRows = std::max<size_t>(1, std::stoul(argv[++i]));
+        else if (arg == "--float") floatFeatures = true;
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(outDir, ec);
+    if (ec) {
+        std::cerr << "❌ Error: cannot create " << outDir << ": " << ec.message() << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ShardWriter writer(outDir, shardRows, floatFeatures);
+    bool writeOk = true;
+
+    if (!storePath.empty()) {
+        MappedStore store;
+        OracleState state;
+        if (!store.open(storePath)) {
+            std::cerr << "❌ Error: cannot map " << storePath << "\n";
+            return 1;
+        }
+        if (!loadState(statePath, state) || state.rows != store.size()) {
+            std::cerr << "❌ Error: " << statePath << " does not match " << storePath << "; run oracle_update first\n";
+            return 1;
+        }
+
+        OracleWeights weights;
+        if (!loadWeights("oracle/oracle_weights.json", weights)) {
+            std::cerr << "❌ Error: malformed oracle/oracle_weights.json\n";
+            return 1;
+        }
+
+        // Same score as oracle_update and oracle_dispatcher rank by
+        std::vector<RankedRow> scored = scoreRealRows(state, store, weights);
+        if (scored.empty()) {
+            std::cerr << "❌ Error: " << storePath << " has no real midstates to label\n";
+            return 1;
+        }
+        for (size_t i = 0; i < scored.size() && writeOk; ++i) {
+            const StoreRecord& rec = store[scored[i].row];
+            writeOk = writer.add(rec.midstate, rec.tail, static_cast<float>(scored[i].score));
+        }
+        size_t synthetic = store.size() - scored.size();
+        if (synthetic) std::cerr << "⚠️ Skipped " << synthetic << " synthetic rows\n";
+    } else {
+        std::ifstream in(jsonPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << jsonPath << " not found.\n";
+            return 1;
+        }
+
+        size_t skipped = 0;
+        std::string error;
+        bool ok = streamMidstates(in, [&](MidstateRecord&& m) {
+            uint8_t midstate[32], tail[16];
+            if (!m.hasScore || m.midstate.size() != 64 || m.tail.size() != 32 ||
+                !hexDecode(m.midstate, midstate) || !hexDecode(m.tail, tail)) {
+                ++skipped;
+                return;
+            }
+            writeOk = writeOk && writer.add(midstate, tail, static_cast<float>(m.score));
+        }, &error);
+
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << jsonPath << ": " << error << "\n";
+            return 1;
+        }
+        if (skipped) std::cerr << "⚠️ Skipped " << skipped << " entries without midstate, tail or score\n";
+    }
+
+    if (!writeOk || !writer.finish()) {
+        std::cerr << "❌ Error: failed to write shards to " << outDir << "\n";
+        return 1;
+    }
+
+    std::cout << "✅ Exported " << writer.rows() << " rows to " << outDir << " [" << msSince(start) << " ms]\n";
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+#include "oracle_store.hpp"
+#include "oracle_weights.hpp"
+#include "parallel.hpp"
+#include "oracle_utils.hpp"
+
+// Fits the oracle's composite score weights by least squares:
+//
+//   fit_weights [--store oracle/midstates.bin] [--out oracle/oracle_weights.json]
+//               [--columns entropy,pattern,...] [--ridge 1e-6] [--holdout 0.2]
+//
+// Every real (non-synthetic) store row is one sample. Features are the
+// columns from oracle_weights.hpp, the label is the number of leading zero
+// bits of the row's actual block hash. oracle_dispatcher loads the result.
+//
+// The newest --holdout fraction of rows by height is left out of the fit and
+// the newest fitted height is saved with the weights, so backtest_oracle can
+// score only rows the fit never saw. --holdout 0 fits every row, leaving
+// nothing to backtest against.
+
+// Normal-equation sums over a range of rows: [1, x] outer products and [1, x] * y
+struct Moments {
+    static constexpr size_t kDim = kColumnCount + 1;
+    double xx[kDim][kDim] = {};
+    double xy[kDim] = {};
+    double yy = 0.0;
+    uint64_t n = 0;
+
+    void add(const FeatureVector& f, double y) {
+        double x[kDim] = {1.0};
+        for (size_t c = 0; c < kColumnCount; ++c) x[c + 1] = f[c];
+        for (size_t a = 0; a < kDim; ++a) {
+            for (size_t b = 0; b <= a; ++b) xx[a][b] += x[a] * x[b];
+            xy[a] += x[a] * y;
+        }
+        yy += y * y;
+        ++n;
+    }
+
+    void merge(const Moments& o) {
+        for (size_t a = 0; a < kDim; ++a) {
+            for (size_t b = 0; b <= a; ++b) xx[a][b] += o.xx[a][b];
+            xy[a] += o.xy[a];
+        }
+        yy += o.yy;
+        n += o.n;
+    }
+};
+
+// Solves A x = b for symmetric positive definite A (k x k, row-major) by Cholesky
+bool choleskySolve(std::vector<double> A, std::vector<double> b, size_t k, std::vector<double>& x) {
+    for (size_t j = 0; j < k; ++j) {
+        double d = A[j * k + j];
+        for (size_t p = 0; p < j; ++p) d -= A[j * k + p] * A[j * k + p];
+        if (d <= 0.0) return false;
+        A[j * k + j] = std::sqrt(d);
+        for (size_t i = j + 1; i < k; ++i) {
+            double s = A[i * k + j];
+            for (size_t p = 0; p < j; ++p) s -= A[i * k + p] * A[j * k + p];
+            A[i * k + j] = s / A[j * k + j];
+        }
+    }
+    for (size_t i = 0; i < k; ++i) {
+        for (size_t p = 0; p < i; ++p) b[i] -= A[i * k + p] * b[p];
+        b[i] /= A[i * k + i];
+    }
+    for (size_t i = k; i-- > 0;) {
+        for (size_t p = i + 1; p < k; ++p) b[i] -= A[p * k + i] * b[p];
+        b[i] /= A[i * k + i];
+    }
+    x = std::move(b);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string outPath = "oracle/oracle_weights.json";
+    std::string columnList;
+    double ridge = 1e-6;
+    double holdout = 0.2;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--columns") columnList = argv[i + 1];
+        else if (arg == "--ridge") ridge = std::stod(argv[i + 1]);
+        else if (arg == "--holdout") holdout = std::stod(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (!(holdout >= 0.0 && holdout < 1.0)) {
+        std::cerr << "❌ --holdout must be in [0, 1)\n";
+        return 1;
+    }
+
+    std::vector<size_t> columns;
+    if (columnList.empty()) {
+        for (size_t c = 0; c < kColumnCount; ++c) columns.push_back(c);
+    } else {
+        std::stringstream ss(columnList);
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            size_t c = 0;
+            while (c < kColumnCount && name != kColumnNames[c]) ++c;
+            if (c == kColumnCount) {
+                std::cerr << "❌ Unknown feature column: " << name << "\n";
+                return 1;
+            }
+            columns.push_back(c);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    // Real blocks only; synthetic rows have no hash to learn from. Pattern
+    // uses the first-byte histogram of all of them, as the dispatcher would.
+    std::vector<uint32_t> rows;
+    std::vector<uint32_t> heights;
+    uint64_t prefixCounts[256] = {};
+    rows.reserve(store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store[i].flags & kStoreSynthetic) continue;
+        rows.push_back(static_cast<uint32_t>(i));
+        heights.push_back(store[i].height);
+        ++prefixCounts[store[i].midstate[0]];
+    }
+
+    // Fit rows: heights up to the (1 - holdout) quantile; rows sharing the cut height stay in
+    size_t heldOut = 0;
+    if (holdout > 0.0 && !rows.empty()) {
+        size_t keep = std::max<size_t>(1, static_cast<size_t>(rows.size() * (1.0 - holdout)));
+        std::nth_element(heights.begin(), heights.begin() + (keep - 1), heights.end());
+        uint32_t cutHeight = heights[keep - 1];
+        size_t kept = 0;
+        for (uint32_t r : rows)
+            if (store[r].height <= cutHeight) rows[kept++] = r;
+        heldOut = rows.size() - kept;
+        rows.resize(kept);
+    }
+    const size_t n = rows.size();
+    if (n < columns.size() + 1) {
+        std::cerr << "❌ Error: need more than " << columns.size() << " labeled rows, have " << n << "\n";
+        return 1;
+    }
+
+    // Feature columns, in parallel
+    std::vector<uint8_t> midstates(n * 32), tails(n * 16);
+    std::vector<double> labels(n), pattern(n);
+    int64_t fitMaxHeight = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const StoreRecord& rec = store[rows[i]];
+        std::copy(rec.midstate, rec.midstate + 32, &midstates[i * 32]);
+        std::copy(rec.tail, rec.tail + 16, &tails[i * 16]);
+        labels[i] = leadingZeroBits(rec.blockhash);
+        fitMaxHeight = std::max<int64_t>(fitMaxHeight, rec.height);
+    }
+    double maxCount = static_cast<double>(*std::max_element(std::begin(prefixCounts), std::end(prefixCounts)));
+    for (size_t i = 0; i < n; ++i) pattern[i] = prefixCounts[midstates[i * 32]] / maxCount;
+
+    std::vector<FeatureVector> features(n);
+    computeFeatureRows(midstates.data(), tails.data(), pattern.data(), n, features.data());
+    std::cout << "📐 " << n << " rows x " << columns.size() << " columns, heights <= " << fitMaxHeight << " ("
+              << heldOut << " newer rows held out) [" << msSince(start) << " ms]\n";
+
+    // Normal equations, one partial sum per thread chunk, merged in row order
+    std::vector<std::pair<size_t, Moments>> partials;
+    std::mutex partialsMutex;
+    parallelFor(n, [&](size_t begin, size_t end) {
+        Moments m;
+        for (size_t i = begin; i < end; ++i) m.add(features[i], labels[i]);
+        std::lock_guard<std::mutex> lock(partialsMutex);
+        partials.emplace_back(begin, m);
+    }, 16384);
+    std::sort(partials.begin(), partials.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    Moments total;
+    for (const auto& p : partials) total.merge(p.second);
+
+    // Ridge least squares on standardized columns, then mapped back to raw units.
+    // Constant columns get weight 0.
+    const size_t k = columns.size();
+    const double N = static_cast<double>(total.n);
+    auto sumX = [&](size_t c) { return total.xx[c + 1][0]; };
+    auto sumXX = [&](size_t a, size_t b) { return a >= b ? total.xx[a + 1][b + 1] : total.xx[b + 1][a + 1]; };
+    double meanY = total.xy[0] / N;
+
+    std::vector<double> mean(k), scale(k);
+    for (size_t i = 0; i < k; ++i) {
+        mean[i] = sumX(columns[i]) / N;
+        double var = sumXX(columns[i], columns[i]) / N - mean[i] * mean[i];
+        scale[i] = var > 1e-12 ? std::sqrt(var) : 0.0;
+    }
+
+    std::vector<double> A(k * k, 0.0), b(k, 0.0), beta;
+    for (size_t i = 0; i < k; ++i) {
+        size_t ci = columns[i];
+        if (scale[i] == 0.0) {
+            A[i * k + i] = 1.0;
+            continue;
+        }
+        for (size_t j = 0; j < k; ++j) {
+            size_t cj = columns[j];
+            if (scale[j] == 0.0) continue;
+            double cov = sumXX(ci, cj) / N - mean[i] * mean[j];
+            A[i * k + j] = cov / (scale[i] * scale[j]);
+        }
+        A[i * k + i] += ridge;
+        b[i] = (total.xy[ci + 1] / N - mean[i] * meanY) / scale[i];
+    }
+    if (!choleskySolve(A, b, k, beta)) {
+        std::cerr << "❌ Error: feature columns are degenerate; raise --ridge or drop columns\n";
+        return 1;
+    }
+
+    OracleWeights weights;
+    weights.w.fill(0.0);
+    weights.bias = meanY;
+    weights.fitMaxHeight = fitMaxHeight;
+    for (size_t i = 0; i < k; ++i) {
+        if (scale[i] == 0.0) continue;
+        weights.w[columns[i]] = beta[i] / scale[i];
+        weights.bias -= weights.w[columns[i]] * mean[i];
+    }
+
+    // R^2 from the sums: SSE = yy - 2 w.Xy + w.XX.w over the [1, x] design
+    double full[Moments::kDim] = {weights.bias};
+    for (size_t c = 0; c < kColumnCount; ++c) full[c + 1] = weights.w[c];
+    double sse = total.yy;
+    for (size_t a = 0; a < Moments::kDim; ++a) {
+        sse -= 2.0 * full[a] * total.xy[a];
+        for (size_t c = 0; c < Moments::kDim; ++c)
+            sse += full[a] * full[c] * (a >= c ? total.xx[a][c] : total.xx[c][a]);
+    }
+    double sst = total.yy - N * meanY * meanY;
+    double r2 = sst > 0.0 ? 1.0 - sse / sst : 0.0;
+
+    if (!saveWeights(outPath, weights, "leading_zero_bits", n, r2)) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+
+    std::cout << "📊 bias " << weights.bias;
+    for (size_t c : columns) std::cout << ", " << kColumnNames[c] << " " << weights.w[c];
+    std::cout << " (R² " << r2 << ")\n";
+    std::cout << "✅ Saved weights to " << outPath << " [" << msSince(start) << " ms]\n";
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include "../hex_codec.hpp"
+#include "header_ingest.hpp"
+#include "midstate_stream.hpp"
+#include "oracle_store.hpp"
+#include "parallel.hpp"
+#include "oracle_utils.hpp"
+
+// Appends synthetic header prefixes to the midstate store, for baselines and
+// null distributions:
+//
+//   generate_synthetic --count N [--headers oracle/block_headers.json | --raw headers.bin]
+//                      [--store oracle/midstates.bin] [--seed 1]
+//
+// Every row copies version, previous hash, time and bits from a real header
+// picked at random, and gets a random merkle root and nonce. Rows carry the
+// template's height and kStoreSynthetic; their block hash is zero. Row i of
+// a run depends only on the seed and i, so a run is reproducible regardless
+// of thread count.
+
+// Rows generated, hashed and appended per batch
+constexpr size_t kBatchSize = 1 << 18;
+
+struct Template {
+    Header80 header;
+    uint32_t height;
+};
+
+int main(int argc, char** argv) {
+    std::string headersPath = "oracle/block_headers.json";
+    std::string rawPath;
+    std::string storePath = "oracle/midstates.bin";
+    uint64_t count = 0;
+    uint64_t seed = 1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--count") count = std::stoull(argv[i + 1]);
+        else if (arg == "--headers") headersPath = argv[i + 1];
+        else if (arg == "--raw") rawPath = argv[i + 1];
+        else if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--seed") seed = std::stoull(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (count == 0) {
+        std::cerr << "❌ Pass --count N (rows to generate)\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Real headers to borrow version, previous hash, time and bits from
+    std::vector<Template> templates;
+    if (!rawPath.empty()) {
+        std::vector<RawHeader> raw;
+        if (!readRawHeaderFile(rawPath, raw)) {
+            std::cerr << "❌ Error: cannot read " << rawPath << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < raw.size(); ++i) templates.push_back({raw[i], static_cast<uint32_t>(i)});
+    } else {
+        std::ifstream in(headersPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << headersPath << " not found.\n";
+            return 1;
+        }
+        std::string error;
+        bool ok = streamHeaders(in, [&](HeaderRecord&& h) {
+            Template t{};
+            if (h.height < 0 || h.headerHex.size() != 160 || !hexDecode(h.headerHex, t.header.bytes)) return;
+            t.height = static_cast<uint32_t>(h.height);
+            templates.push_back(t);
+        }, &error);
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << headersPath << ": " << error << "\n";
+            return 1;
+        }
+    }
+    if (templates.empty()) {
+        std::cerr << "❌ Error: no template headers in " << (rawPath.empty() ? headersPath : rawPath) << "\n";
+        return 1;
+    }
+    std::cout << "📂 " << templates.size() << " template headers [" << msSince(start) << " ms]\n";
+
+    StoreWriter store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot open " << storePath << "\n";
+        return 1;
+    }
+
+    std::vector<Header80> headers;
+    std::vector<uint32_t> heights;
+    std::vector<StoreRecord> records;
+    auto genStart = std::chrono::steady_clock::now();
+    for (uint64_t begin = 0; begin < count; begin += kBatchSize) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(kBatchSize, count - begin));
+        headers.resize(n);
+        heights.resize(n);
+        records.resize(n);
+
+        parallelFor(n, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                uint64_t state = seed ^ ((begin + i) * 0xD1B54A32D192ED03ull);
+                const Template& t = templates[static_cast<size_t>(
+                    (static_cast<unsigned __int128>(splitmix64(state)) * templates.size()) >> 64)];
+
+                // Random merkle root (bytes 36..67) and nonce (76..79)
+                Header80& h = headers[i];
+                h = t.header;
+                for (size_t k = 0; k < 4; ++k) {
+                    uint64_t r = splitmix64(state);
+                    std::memcpy(h.bytes + 36 + 8 * k, &r, 8);
+                }
+                uint32_t nonce = static_cast<uint32_t>(splitmix64(state));
+                std::memcpy(h.bytes + 76, &nonce, 4);
+                heights[i] = t.height;
+            }
+        }, 4096);
+
+        fillStoreRecords(headers, records);
+        for (size_t i = 0; i < n; ++i) {
+            records[i].height = heights[i];
+            records[i].flags = kStoreSynthetic;
+        }
+        if (!store.append(records.data(), n) || !store.flush()) {
+            std::cerr << "❌ Error: failed to append to " << storePath << "\n";
+            return 1;
+        }
+    }
+
+    double ms = msSince(genStart);
+    std::cout << "✅ Appended " << count << " synthetic midstates to " << storePath << " (" << store.size()
+              << " total) [" << ms << " ms, " << count / (ms * 1e3) << " M/s]\n";
+    return 0;
+}
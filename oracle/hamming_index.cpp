@@ -0,0 +1,234 @@
+#include "hamming_index.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr size_t kKeyBits = 16;
+constexpr size_t kKeys = size_t(1) << kKeyBits;
+
+// Queries scanned together, sharing each pass over the codes
+constexpr size_t kScanTile = 8;
+
+// A probed candidate costs a few scanned codes (random access, dedup)
+constexpr double kProbeEntryCost = 4.0;
+
+constexpr Neighbor kNoNeighbor = {std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max()};
+
+inline bool closer(const Neighbor& a, const Neighbor& b) {
+    return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+}
+
+// Sorted best-k list; k is small, so insertion is a shift
+struct TopK {
+    Neighbor* best;
+    size_t k;
+    size_t count = 0;
+
+    TopK(Neighbor* out, size_t k) : best(out), k(k) { std::fill(out, out + k, kNoNeighbor); }
+
+    bool full() const { return count == k; }
+    uint32_t worstDistance() const { return full() ? best[k - 1].distance : kNoNeighbor.distance; }
+
+    void push(Neighbor n) {
+        if (full() && !closer(n, best[k - 1])) return;
+        size_t i = full() ? k - 1 : count++;
+        while (i > 0 && closer(n, best[i - 1])) {
+            best[i] = best[i - 1];
+            --i;
+        }
+        best[i] = n;
+    }
+};
+
+// 16-bit masks grouped by popcount, for enumerating bucket keys at a given distance
+const std::vector<std::vector<uint16_t>>& masksByWeight() {
+    static const std::vector<std::vector<uint16_t>> masks = [] {
+        std::vector<std::vector<uint16_t>> m(kKeyBits + 1);
+        for (size_t v = 0; v < kKeys; ++v) m[std::popcount(v)].push_back(static_cast<uint16_t>(v));
+        return m;
+    }();
+    return masks;
+}
+
+// Per-thread visited marks for deduplicating candidates across tables
+struct Visited {
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+
+    void begin(size_t n) {
+        if (stamp.size() < n) stamp.resize(n, 0);
+        if (++epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool first(uint32_t id) {
+        if (stamp[id] == epoch) return false;
+        stamp[id] = epoch;
+        return true;
+    }
+};
+
+thread_local Visited visited;
+
+} // namespace
+
+HammingIndex::Code HammingIndex::load(const uint8_t* p) {
+    Code c;
+    std::memcpy(c.data(), p, sizeof(c));
+    return c;
+}
+
+uint16_t HammingIndex::substring(const Code& c, size_t j) {
+    return static_cast<uint16_t>(c[j / 4] >> (16 * (j % 4)));
+}
+
+uint32_t HammingIndex::distance(const Code& a, const Code& b) {
+    return static_cast<uint32_t>(std::popcount(a[0] ^ b[0]) + std::popcount(a[1] ^ b[1]) +
+                                 std::popcount(a[2] ^ b[2]) + std::popcount(a[3] ^ b[3]));
+}
+
+void HammingIndex::build(const uint8_t* data, size_t n) {
+    codes.resize(n);
+    for (size_t i = 0; i < n; ++i) codes[i] = load(data + i * 32);
+
+    bucketStart.assign(kSubstrings, {});
+    ids.assign(kSubstrings, {});
+    parallelFor(kSubstrings, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            // Counting sort of ids by substring value
+            std::vector<uint32_t>& start = bucketStart[j];
+            start.assign(kKeys + 1, 0);
+            for (const Code& c : codes) ++start[substring(c, j) + 1];
+            for (size_t b = 0; b < kKeys; ++b) start[b + 1] += start[b];
+
+            std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+            ids[j].resize(n);
+            for (size_t i = 0; i < n; ++i) ids[j][cursor[substring(codes[i], j)]++] = static_cast<uint32_t>(i);
+        }
+    }, 1);
+}
+
+template <typename Fn>
+void HammingIndex::probe(const Code& q, size_t radius, Fn&& fn) const {
+    for (size_t j = 0; j < kSubstrings; ++j) {
+        uint16_t key = substring(q, j);
+        const std::vector<uint32_t>& start = bucketStart[j];
+        const uint32_t* bucketIds = ids[j].data();
+        for (uint16_t mask : masksByWeight()[radius]) {
+            uint16_t b = key ^ mask;
+            for (uint32_t e = start[b]; e < start[b + 1]; ++e) fn(bucketIds[e]);
+        }
+    }
+}
+
+double HammingIndex::probeCost(size_t radius) const {
+    double buckets = static_cast<double>(kSubstrings * masksByWeight()[radius].size());
+    return buckets * (1.0 + kProbeEntryCost * codes.size() / kKeys);
+}
+
+bool HammingIndex::search(const Code& q, size_t k, Neighbor* out) const {
+    const double budget = static_cast<double>(codes.size());
+    TopK top(out, k);
+    visited.begin(codes.size());
+
+    double spent = 0.0;
+    for (size_t r = 0; r <= kKeyBits; ++r) {
+        // Codes not seen yet differ in at least r bits on every substring
+        if (top.full() && top.worstDistance() < kSubstrings * r) return true;
+
+        // Radius needed to confirm the current k-th best, if known
+        size_t needed = top.full() ? top.worstDistance() / kSubstrings : r;
+        double cost = 0.0;
+        for (size_t s = r; s <= std::min(needed, kKeyBits); ++s) cost += probeCost(s);
+        if (spent + cost > budget) return false;
+
+        probe(q, r, [&](uint32_t id) {
+            if (visited.first(id)) top.push({id, distance(q, codes[id])});
+        });
+        spent += probeCost(r);
+    }
+    return true;
+}
+
+void HammingIndex::scan(const Code* queries, size_t nq, size_t k, Neighbor* out) const {
+    for (size_t t0 = 0; t0 < nq; t0 += kScanTile) {
+        size_t tile = std::min(kScanTile, nq - t0);
+        std::vector<TopK> tops;
+        tops.reserve(tile);
+        uint32_t worst[kScanTile];
+        for (size_t t = 0; t < tile; ++t) {
+            tops.emplace_back(out + (t0 + t) * k, k);
+            worst[t] = kNoNeighbor.distance;
+        }
+
+        for (size_t i = 0; i < codes.size(); ++i) {
+            const Code& c = codes[i];
+            for (size_t t = 0; t < tile; ++t) {
+                uint32_t d = distance(queries[t0 + t], c);
+                // Ids ascend, so an equal distance never displaces an earlier code
+                if (d >= worst[t]) continue;
+                tops[t].push({static_cast<uint32_t>(i), d});
+                worst[t] = tops[t].full() ? tops[t].worstDistance() : kNoNeighbor.distance;
+            }
+        }
+    }
+}
+
+std::vector<Neighbor> HammingIndex::knn(const uint8_t* query, size_t k) const {
+    std::vector<Neighbor> out(k);
+    if (k == 0) return out;
+    Code q = load(query);
+    if (!search(q, k, out.data())) scan(&q, 1, k, out.data());
+    return out;
+}
+
+void HammingIndex::knnBatch(const uint8_t* queries, size_t nq, size_t k, std::vector<Neighbor>& out) const {
+    out.assign(nq * k, kNoNeighbor);
+    if (k == 0) return;
+
+    parallelFor(nq, [&](size_t begin, size_t end) {
+        // Queries the index cannot answer cheaply share scan passes
+        std::vector<Code> pending;
+        std::vector<size_t> pendingIds;
+        for (size_t i = begin; i < end; ++i) {
+            Code q = load(queries + i * 32);
+            if (search(q, k, &out[i * k])) continue;
+            pending.push_back(q);
+            pendingIds.push_back(i);
+        }
+
+        std::vector<Neighbor> scanned(pending.size() * k);
+        scan(pending.data(), pending.size(), k, scanned.data());
+        for (size_t p = 0; p < pendingIds.size(); ++p)
+            std::copy_n(&scanned[p * k], k, &out[pendingIds[p] * k]);
+    }, 64);
+}
+
+size_t HammingIndex::countWithin(const uint8_t* query, uint32_t radius) const {
+    Code q = load(query);
+    size_t maxR = std::min<size_t>(radius / kSubstrings, kKeyBits);
+
+    double cost = 0.0;
+    for (size_t r = 0; r <= maxR; ++r) cost += probeCost(r);
+
+    size_t count = 0;
+    if (cost > static_cast<double>(codes.size())) {
+        for (const Code& c : codes) count += distance(q, c) <= radius;
+        return count;
+    }
+
+    // Pigeonhole: a code within radius matches some substring within radius / 16 bits
+    visited.begin(codes.size());
+    for (size_t r = 0; r <= maxR; ++r) {
+        probe(q, r, [&](uint32_t id) {
+            if (visited.first(id) && distance(q, codes[id]) <= radius) ++count;
+        });
+    }
+    return count;
+}
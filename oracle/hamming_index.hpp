@@ -0,0 +1,67 @@
+// hamming_index.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Exact k-nearest-neighbour search by Hamming distance over 256-bit midstates.
+//
+// Codes are split into 16 substrings of 16 bits, each with its own bucket
+// table (multi-index hashing): a code within distance r of the query matches
+// it within floor(r / 16) bits on at least one substring, so probing bucket
+// keys at increasing substring radius finds near neighbours after touching a
+// handful of buckets. When the neighbours are far (as they are for
+// independent SHA-256 states, typically 80+ bits apart) probing would visit
+// more candidates than exist, and the query falls back to a linear popcount
+// scan. knnBatch() shares that scan across a tile of queries.
+
+struct Neighbor {
+    uint32_t id;        // index of the code passed to build()
+    uint32_t distance;  // Hamming distance in bits
+};
+
+class HammingIndex {
+public:
+    static constexpr size_t kSubstrings = 16;
+
+    // Indexes n consecutive 32-byte codes (copied)
+    void build(const uint8_t* codes, size_t n);
+
+    size_t size() const { return codes.size(); }
+
+    // k nearest codes to query, by distance then id
+    std::vector<Neighbor> knn(const uint8_t* query, size_t k) const;
+
+    // k nearest for each of nq queries (32 bytes each), across threads.
+    // out[q * k + j] is the j-th neighbour of query q; missing ones have distance UINT32_MAX.
+    void knnBatch(const uint8_t* queries, size_t nq, size_t k, std::vector<Neighbor>& out) const;
+
+    // Number of codes within `radius` bits of query
+    size_t countWithin(const uint8_t* query, uint32_t radius) const;
+
+private:
+    using Code = std::array<uint64_t, 4>;
+
+    static Code load(const uint8_t* p);
+    static uint16_t substring(const Code& c, size_t j);
+    static uint32_t distance(const Code& a, const Code& b);
+
+    // Probes every table at substring radius exactly `radius`, calling fn(id) per bucket entry
+    template <typename Fn>
+    void probe(const Code& q, size_t radius, Fn&& fn) const;
+
+    // Expected work of probing one substring radius in all tables, in scanned-code units
+    double probeCost(size_t radius) const;
+
+    // Multi-index search; false if it would cost more than a scan
+    bool search(const Code& q, size_t k, Neighbor* out) const;
+
+    // Linear scan for a tile of queries at once
+    void scan(const Code* queries, size_t nq, size_t k, Neighbor* out) const;
+
+    std::vector<Code> codes;
+    // Per table: bucketStart[65537] offsets into ids (CSR)
+    std::vector<std::vector<uint32_t>> bucketStart;
+    std::vector<std::vector<uint32_t>> ids;
+};
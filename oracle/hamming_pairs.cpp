@@ -0,0 +1,91 @@
+#include "hamming_pairs.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t kLanes = 8;
+
+// Column groups per tile: 128 x 8 codes x 32 bytes stays in L1/L2 while a band's rows pass over it
+constexpr size_t kTileGroups = 128;
+
+// Word w of codes 8g .. 8g+7, lane by lane
+struct alignas(64) CodeGroup {
+    uint64_t word[4][kLanes];
+};
+
+std::vector<CodeGroup> pack(const uint8_t* codes, size_t n) {
+    std::vector<CodeGroup> groups((n + kLanes - 1) / kLanes, CodeGroup{});
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t w[4];
+        std::memcpy(w, codes + i * 32, sizeof(w));
+        for (size_t k = 0; k < 4; ++k) groups[i / kLanes].word[k][i % kLanes] = w[k];
+    }
+    return groups;
+}
+
+// Distances from one row to the 8 codes of each group in [g0, g1), written to out[8g ..]
+void rowDistances(const uint64_t row[4], const CodeGroup* groups, size_t g0, size_t g1, uint16_t* out) {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i r0 = _mm512_set1_epi64(static_cast<long long>(row[0]));
+    __m512i r1 = _mm512_set1_epi64(static_cast<long long>(row[1]));
+    __m512i r2 = _mm512_set1_epi64(static_cast<long long>(row[2]));
+    __m512i r3 = _mm512_set1_epi64(static_cast<long long>(row[3]));
+    for (size_t g = g0; g < g1; ++g) {
+        const CodeGroup& c = groups[g];
+        __m512i d = _mm512_popcnt_epi64(_mm512_xor_si512(r0, _mm512_load_si512(c.word[0])));
+        d = _mm512_add_epi64(d, _mm512_popcnt_epi64(_mm512_xor_si512(r1, _mm512_load_si512(c.word[1]))));
+        d = _mm512_add_epi64(d, _mm512_popcnt_epi64(_mm512_xor_si512(r2, _mm512_load_si512(c.word[2]))));
+        d = _mm512_add_epi64(d, _mm512_popcnt_epi64(_mm512_xor_si512(r3, _mm512_load_si512(c.word[3]))));
+        _mm512_mask_cvtepi64_storeu_epi16(out + g * kLanes, 0xFF, d);
+    }
+#else
+    for (size_t g = g0; g < g1; ++g) {
+        const CodeGroup& c = groups[g];
+        for (size_t l = 0; l < kLanes; ++l) {
+            out[g * kLanes + l] = static_cast<uint16_t>(
+                std::popcount(row[0] ^ c.word[0][l]) + std::popcount(row[1] ^ c.word[1][l]) +
+                std::popcount(row[2] ^ c.word[2][l]) + std::popcount(row[3] ^ c.word[3][l]));
+        }
+    }
+#endif
+}
+
+} // namespace
+
+void forEachDistanceBand(const uint8_t* codes, size_t n,
+                         const std::function<void(const DistanceBand&)>& onBand) {
+    if (n < 2) return;
+    const std::vector<CodeGroup> groups = pack(codes, n);
+    const size_t groupCount = groups.size();
+
+    // Rows are padded to whole groups so the kernel never needs a tail case
+    const size_t stride = groupCount * kLanes;
+    std::vector<uint16_t> band(kBandRows * stride);
+
+    for (size_t rowBegin = 0; rowBegin + 1 < n; rowBegin += kBandRows) {
+        size_t rows = std::min(kBandRows, n - 1 - rowBegin);
+        // Only columns after the band's first row are needed
+        size_t firstGroup = (rowBegin + 1) / kLanes;
+
+        parallelFor(groupCount - firstGroup, [&](size_t begin, size_t end) {
+            for (size_t t0 = firstGroup + begin; t0 < firstGroup + end; t0 += kTileGroups) {
+                size_t t1 = std::min(firstGroup + end, t0 + kTileGroups);
+                for (size_t r = 0; r < rows; ++r) {
+                    uint64_t row[4];
+                    std::memcpy(row, codes + (rowBegin + r) * 32, sizeof(row));
+                    rowDistances(row, groups.data(), t0, t1, &band[r * stride]);
+                }
+            }
+        }, 64);
+
+        onBand(DistanceBand{rowBegin, rows, n, stride, band.data()});
+    }
+}
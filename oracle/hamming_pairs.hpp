@@ -0,0 +1,37 @@
+// hamming_pairs.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+// All-pairs Hamming distances over 256-bit codes (midstates or block hashes).
+//
+// Codes are repacked in groups of 8 with each 64-bit word stored lane by
+// lane, so a single AVX-512 VPOPCNTQ covers one word of 8 codes; without
+// VPOPCNTDQ the same loop runs on 64-bit popcounts. Rows are produced in
+// bands of kBandRows, each computed across threads over cache-sized column
+// tiles and handed to the caller in row order, so the n x n matrix is never
+// held in memory.
+
+struct DistanceBand {
+    size_t rowBegin;            // first row of the band
+    size_t rows;                // rows in the band
+    size_t n;                   // number of codes
+    size_t stride;              // row stride of distances, at least n
+    const uint16_t* distances;  // rows x stride
+
+    // Distances from row rowBegin + r to every later row, in condensed
+    // (scipy pdist) order
+    std::span<const uint16_t> upper(size_t r) const {
+        size_t i = rowBegin + r;
+        return {distances + r * stride + i + 1, n - i - 1};
+    }
+};
+
+constexpr size_t kBandRows = 64;
+
+// Computes d(i, j) for all i < j over n consecutive 32-byte codes and calls
+// onBand for each band of rows, in order, on the calling thread
+void forEachDistanceBand(const uint8_t* codes, size_t n,
+                         const std::function<void(const DistanceBand&)>& onBand);
@@ -0,0 +1,190 @@
+#include "header_index.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'O', 'R', 'C', 'L', 'I', 'D', 'X', '1'};
+constexpr uint32_t kIndexVersion = 1;
+
+constexpr uint64_t kEmptySlot = UINT64_MAX;
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t minHeight;
+    uint64_t storeRows;  // store size when built, to spot a stale index
+    uint64_t entries;
+    uint64_t heights;    // length of the height table
+    uint64_t slots;      // power of two
+    uint8_t lastHash[32];  // blockhash of the store's last row when built
+};
+static_assert(sizeof(IndexHeader) == 80, "IndexHeader layout is part of the file format");
+
+// Layout: header, height table (uint64 row per height), hash slots (uint64 each)
+
+// Real block hashes start with zero bytes; their low-order end is uniform
+inline uint32_t hashTag(const uint8_t* blockhash) {
+    uint32_t v;
+    std::memcpy(&v, blockhash + 28, 4);
+    return v;
+}
+
+inline uint64_t hashProbe(const uint8_t* blockhash) {
+    uint64_t v;
+    std::memcpy(&v, blockhash + 20, 8);
+    return v;
+}
+
+inline bool realRow(const StoreRecord& rec) {
+    return !(rec.flags & kStoreSynthetic) && rec.height != UINT32_MAX;
+}
+
+bool matchesStore(const IndexHeader& h, const MappedStore& store) {
+    static const uint8_t zeros[32] = {};
+    const uint8_t* last = store.size() ? store[store.size() - 1].blockhash : zeros;
+    return h.storeRows == store.size() && std::memcmp(h.lastHash, last, 32) == 0;
+}
+
+} // namespace
+
+std::string headerIndexPath(const std::string& storePath) {
+    size_t dot = storePath.find_last_of('.');
+    size_t slash = storePath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return storePath + ".idx";
+    return storePath.substr(0, dot) + ".idx";
+}
+
+bool buildHeaderIndex(const MappedStore& store, const std::string& path) {
+    uint32_t lo = UINT32_MAX, hi = 0;
+    uint64_t real = 0;
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (!realRow(store[i])) continue;
+        lo = std::min(lo, store[i].height);
+        hi = std::max(hi, store[i].height);
+        ++real;
+    }
+
+    // Chain heights are dense; a wide spread means the heights are not real
+    if (real && uint64_t(hi) - lo >= 4 * real + (1u << 20)) {
+        std::cerr << "[ERROR] Heights " << lo << ".." << hi << " are too sparse to index " << real << " rows" << std::endl;
+        return false;
+    }
+
+    IndexHeader h{};
+    std::memcpy(h.magic, kIndexMagic, sizeof(kIndexMagic));
+    h.version = kIndexVersion;
+    h.minHeight = real ? lo : 0;
+    h.storeRows = store.size();
+    h.heights = real ? uint64_t(hi) - lo + 1 : 0;
+    h.slots = std::bit_ceil(std::max<uint64_t>(16, real * 2));
+    if (store.size()) std::memcpy(h.lastHash, store[store.size() - 1].blockhash, 32);
+
+    std::vector<uint64_t> rows(h.heights, kNoRow);
+    std::vector<uint64_t> slots(h.slots, kEmptySlot);
+    const uint64_t mask = h.slots - 1;
+    for (size_t i = 0; i < store.size(); ++i) {
+        const StoreRecord& rec = store[i];
+        if (!realRow(rec) || rows[rec.height - lo] != kNoRow) continue;
+        rows[rec.height - lo] = i;
+
+        uint32_t tag = hashTag(rec.blockhash);
+        uint64_t s = hashProbe(rec.blockhash) & mask;
+        bool duplicate = false;
+        for (; slots[s] != kEmptySlot; s = (s + 1) & mask) {
+            if (uint32_t(slots[s] >> 32) != tag) continue;
+            uint64_t other = rows[uint32_t(slots[s]) - lo];
+            if (std::memcmp(store[other].blockhash, rec.blockhash, 32) == 0) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+        slots[s] = (uint64_t(tag) << 32) | rec.height;
+        ++h.entries;
+    }
+
+    // Written beside the target and renamed over it, so a reader never maps half an index
+    std::string tmpPath = path + ".tmp";
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(rows.data(), sizeof(uint64_t), rows.size(), f) == rows.size() &&
+              std::fwrite(slots.data(), sizeof(uint64_t), slots.size(), f) == slots.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool HeaderIndex::open(const std::string& path, const MappedStore& store) {
+    records = nullptr;
+    entries = heights = slotMask = 0;
+    if (!file.open(path, MADV_RANDOM)) return false;
+
+    IndexHeader h{};
+    bool ok = file.size() >= sizeof(h);
+    if (ok) {
+        std::memcpy(&h, file.data(), sizeof(h));
+        ok = std::memcmp(h.magic, kIndexMagic, sizeof(kIndexMagic)) == 0 && h.version == kIndexVersion &&
+             h.slots > 0 && std::has_single_bit(h.slots) && h.entries <= h.slots / 2 &&
+             h.heights <= file.size() / 8 && h.slots <= file.size() / 8 &&
+             file.size() == sizeof(h) + (h.heights + h.slots) * sizeof(uint64_t);
+    }
+    if (!ok) {
+        std::cerr << "[ERROR] Corrupt header index: " << path << std::endl;
+        file.close();
+        return false;
+    }
+    if (!matchesStore(h, store)) {
+        file.close();
+        return false;  // stale
+    }
+
+    records = &store;
+    rows = reinterpret_cast<const uint64_t*>(file.data() + sizeof(h));
+    slots = rows + h.heights;
+    heights = h.heights;
+    slotMask = h.slots - 1;
+    entries = h.entries;
+    lowest = h.minHeight;
+    return true;
+}
+
+bool HeaderIndex::openOrBuild(const std::string& path, const MappedStore& store) {
+    if (open(path, store)) return true;
+    return buildHeaderIndex(store, path) && open(path, store);
+}
+
+uint64_t HeaderIndex::rowAt(uint32_t height) const {
+    if (height < lowest || height - lowest >= heights) return kNoRow;
+    uint64_t row = rows[height - lowest];
+    return row < records->size() ? row : kNoRow;
+}
+
+bool HeaderIndex::heightOf(const uint8_t* blockhash, uint32_t& height) const {
+    uint64_t row = rowOf(blockhash);
+    if (row == kNoRow) return false;
+    height = (*records)[row].height;
+    return true;
+}
+
+uint64_t HeaderIndex::rowOf(const uint8_t* blockhash) const {
+    if (!records) return kNoRow;
+    uint32_t tag = hashTag(blockhash);
+    // Probes stop at an empty slot; load <= 1/2 keeps the runs short
+    for (uint64_t s = hashProbe(blockhash) & slotMask, probes = 0; probes <= slotMask; s = (s + 1) & slotMask, ++probes) {
+        uint64_t slot = slots[s];
+        if (slot == kEmptySlot) return kNoRow;
+        if (uint32_t(slot >> 32) != tag) continue;
+        uint64_t row = rowAt(uint32_t(slot));
+        if (row != kNoRow && std::memcmp((*records)[row].blockhash, blockhash, 32) == 0) return row;
+    }
+    return kNoRow;
+}
@@ -0,0 +1,56 @@
+// header_index.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "mapped_file.hpp"
+#include "oracle_store.hpp"
+
+// Persistent lookup index over the real rows of a midstate store
+// (oracle/midstates.idx beside oracle/midstates.bin), used in place through
+// mmap:
+//   height -> store row, a dense table from the lowest indexed height
+//   block hash -> height, open addressing with linear probing at load <= 1/2
+// A hash slot keeps 32 bits of the hash as a tag; a tag match is confirmed
+// against the full hash in the store, so a lookup touches one or two slots,
+// one height entry and one record.
+
+constexpr uint64_t kNoRow = UINT64_MAX;
+
+// oracle/midstates.bin -> oracle/midstates.idx
+std::string headerIndexPath(const std::string& storePath);
+
+// Indexes every real row of the store. A height or hash seen twice keeps its first row.
+bool buildHeaderIndex(const MappedStore& store, const std::string& path);
+
+class HeaderIndex {
+public:
+    // Maps an index built for this store. Returns false if it is missing,
+    // corrupt or stale (the store has changed since it was built).
+    bool open(const std::string& path, const MappedStore& store);
+
+    // open(), rebuilding the index first if it is missing or stale
+    bool openOrBuild(const std::string& path, const MappedStore& store);
+
+    size_t size() const { return entries; }
+    uint32_t minHeight() const { return lowest; }
+
+    // Store row of the real record at height, or kNoRow
+    uint64_t rowAt(uint32_t height) const;
+
+    // Height of the block with this display-order hash. Returns false if it is not indexed.
+    bool heightOf(const uint8_t* blockhash, uint32_t& height) const;
+
+    // Store row of the block with this hash, or kNoRow
+    uint64_t rowOf(const uint8_t* blockhash) const;
+
+private:
+    MappedFile file;
+    const MappedStore* records = nullptr;
+    const uint64_t* rows = nullptr;  // by height - lowest
+    const uint64_t* slots = nullptr;  // tag << 32 | height
+    uint64_t heights = 0;
+    uint64_t slotMask = 0;
+    uint64_t entries = 0;
+    uint32_t lowest = 0;
+};
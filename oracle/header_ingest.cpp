@@ -0,0 +1,173 @@
+#include "header_ingest.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Network magics of blk*.dat records (mainnet, testnet3, testnet4, signet, regtest)
+constexpr uint32_t kKnownMagics[] = {0xd9b4bef9, 0x0709110b, 0x283f161c, 0x40cf030a, 0xdab5bffa};
+
+struct XorKey {
+    uint8_t bytes[8] = {};
+    bool active = false;
+};
+
+// Copies n bytes from file offset `offset`, undoing blocksdir obfuscation
+inline void copyPlain(uint8_t* dst, const uint8_t* file, size_t offset, size_t n, const XorKey& key) {
+    std::memcpy(dst, file + offset, n);
+    if (!key.active) return;
+    for (size_t i = 0; i < n; ++i) dst[i] ^= key.bytes[(offset + i) % 8];
+}
+
+inline uint32_t readLE32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+void scanBlockFile(const fs::path& path, const XorKey& key, std::vector<RawHeader>& out) {
+    MappedFile file;
+    if (!file.open(path.string())) {
+        std::cerr << "[ERROR] Cannot map " << path << std::endl;
+        return;
+    }
+
+    const uint8_t* data = file.data();
+    size_t size = file.size();
+    size_t offset = 0;
+    while (offset + 8 + 80 <= size) {
+        // Preallocation padding is written as plain zeros, never obfuscated
+        if (readLE32(data + offset) == 0) break;
+
+        uint8_t prefix[8];
+        copyPlain(prefix, data, offset, 8, key);
+        uint32_t magic = readLE32(prefix);
+        uint32_t length = readLE32(prefix + 4);
+
+        if (std::find(std::begin(kKnownMagics), std::end(kKnownMagics), magic) == std::end(kKnownMagics)) {
+            std::cerr << "⚠️ Unknown record magic in " << path << " at offset " << offset << ", stopping\n";
+            break;
+        }
+        if (length < 80 || offset + 8 + length > size) break;  // truncated last record
+
+        RawHeader h;
+        copyPlain(h.bytes, data, offset + 8, 80, key);
+        out.push_back(h);
+        offset += 8 + static_cast<size_t>(length);
+    }
+}
+
+struct HashKeyHasher {
+    size_t operator()(const Hash256& h) const {
+        uint64_t v;
+        std::memcpy(&v, h.data(), sizeof(v));
+        return static_cast<size_t>(v);
+    }
+};
+
+// Expected work of one block from its compact target
+double blockWork(uint32_t bits) {
+    int exponent = static_cast<int>(bits >> 24);
+    uint32_t mantissa = bits & 0x007fffff;
+    if (mantissa == 0) return 0.0;
+    return std::ldexp(1.0 / mantissa, 256 - 8 * (exponent - 3));
+}
+
+} // namespace
+
+bool readRawHeaderFile(const std::string& path, std::vector<RawHeader>& out) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    if (file.size() % sizeof(RawHeader) != 0) {
+        std::cerr << "⚠️ " << path << " is not a multiple of 80 bytes, ignoring the partial tail\n";
+    }
+
+    size_t count = file.size() / sizeof(RawHeader);
+    out.resize(count);
+    if (count) std::memcpy(out.data(), file.data(), count * sizeof(RawHeader));
+    return true;
+}
+
+bool scanBlockFiles(const std::string& blocksDir, std::vector<RawHeader>& out) {
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(blocksDir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("blk", 0) == 0 && entry.path().extension() == ".dat") files.push_back(entry.path());
+    }
+    if (ec) {
+        std::cerr << "[ERROR] Cannot read blocks directory " << blocksDir << ": " << ec.message() << std::endl;
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    XorKey key;
+    std::ifstream xorFile(fs::path(blocksDir) / "xor.dat", std::ios::binary);
+    if (xorFile && xorFile.read(reinterpret_cast<char*>(key.bytes), sizeof(key.bytes))) {
+        key.active = std::any_of(std::begin(key.bytes), std::end(key.bytes), [](uint8_t b) { return b != 0; });
+    }
+
+    std::vector<std::vector<RawHeader>> perFile(files.size());
+    parallelFor(files.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) scanBlockFile(files[i], key, perFile[i]);
+    }, 1);
+
+    size_t total = 0;
+    for (const auto& v : perFile) total += v.size();
+    out.clear();
+    out.reserve(total);
+    for (const auto& v : perFile) out.insert(out.end(), v.begin(), v.end());
+    return true;
+}
+
+std::vector<uint32_t> bestChain(const std::vector<RawHeader>& headers,
+                                const std::vector<Hash256>& hashes) {
+    const size_t n = headers.size();
+    constexpr int64_t kNone = -1;
+
+    std::unordered_map<Hash256, uint32_t, HashKeyHasher> index;
+    index.reserve(n);
+    for (size_t i = 0; i < n; ++i) index.emplace(hashes[i], static_cast<uint32_t>(i));
+
+    std::vector<int64_t> parent(n, kNone);
+    parallelFor(n, [&](size_t begin, size_t end) {
+        Hash256 prev;
+        for (size_t i = begin; i < end; ++i) {
+            std::memcpy(prev.data(), headers[i].bytes + 4, 32);
+            auto it = index.find(prev);
+            if (it != index.end() && it->second != i) parent[i] = it->second;
+        }
+    });
+
+    // Cumulative work, resolved iteratively so long chains cannot overflow the stack
+    std::vector<double> work(n, -1.0);
+    std::vector<uint32_t> pending;
+    for (size_t i = 0; i < n; ++i) {
+        int64_t cur = static_cast<int64_t>(i);
+        while (cur != kNone && work[cur] < 0.0) {
+            pending.push_back(static_cast<uint32_t>(cur));
+            cur = parent[cur];
+        }
+        double base = cur == kNone ? 0.0 : work[cur];
+        while (!pending.empty()) {
+            uint32_t j = pending.back();
+            pending.pop_back();
+            base += blockWork(readLE32(headers[j].bytes + 72));
+            work[j] = base;
+        }
+    }
+
+    std::vector<uint32_t> chain;
+    if (n == 0) return chain;
+    int64_t tip = std::max_element(work.begin(), work.end()) - work.begin();
+    for (int64_t cur = tip; cur != kNone; cur = parent[cur]) chain.push_back(static_cast<uint32_t>(cur));
+    std::reverse(chain.begin(), chain.end());
+    return chain;
+}
@@ -0,0 +1,25 @@
+// header_ingest.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "midstate_batch.hpp"
+
+// Native header ingestion without RPC: Bitcoin Core blk*.dat files or flat
+// files of consecutive 80-byte headers, both read through mmap.
+
+using RawHeader = Header80;
+
+// Reads a flat file of consecutive 80-byte headers
+bool readRawHeaderFile(const std::string& path, std::vector<RawHeader>& out);
+
+// Extracts the 80-byte header of every block in <blocksDir>/blk*.dat, one
+// file per worker thread. Applies the xor.dat obfuscation key when present.
+// Headers come out in file order, which is not chain order.
+bool scanBlockFiles(const std::string& blocksDir, std::vector<RawHeader>& out);
+
+// Links headers by prevBlockHash, given their hashHeaders() digests, and
+// returns the indices of the most-work chain in height order (index 0 is the
+// root of that chain). Stale and orphaned headers are left out.
+std::vector<uint32_t> bestChain(const std::vector<RawHeader>& headers,
+                                const std::vector<Hash256>& hashes);
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "../hex_codec.hpp"
+#include "header_index.hpp"
+#include "midstate_stream.hpp"
+#include "oracle_store.hpp"
+#include "oracle_utils.hpp"
+
+// Looks up store rows by block hash or height through the mmap'd header index,
+// building or refreshing oracle/midstates.idx first when it is missing or stale:
+//
+//   header_lookup [--store oracle/midstates.bin] [--index oracle/midstates.idx]
+//                 [--hash <hex> | --height H | --join oracle/top_midstates.json]
+//
+// --join looks up the "blockhash" of every entry of a JSON array and reports
+// how many are in the store. With no query, every real row is looked up by
+// hash and by height as a self-check and benchmark.
+
+void printRow(const MappedStore& store, uint64_t row) {
+    const StoreRecord& rec = store[row];
+    std::cout << "   height " << rec.height << ", row " << row << "\n"
+              << "   blockhash " << hexEncode(rec.blockhash, 32) << "\n"
+              << "   midstate  " << hexEncode(rec.midstate, 32) << "\n"
+              << "   tail      " << hexEncode(rec.tail, 16) << "\n";
+}
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string indexPath;
+    std::string hashHex;
+    std::string joinPath;
+    int64_t height = -1;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--index") indexPath = argv[i + 1];
+        else if (arg == "--hash") hashHex = argv[i + 1];
+        else if (arg == "--height") height = std::stoll(argv[i + 1]);
+        else if (arg == "--join") joinPath = argv[i + 1];
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (indexPath.empty()) indexPath = headerIndexPath(storePath);
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    HeaderIndex index;
+    if (!index.openOrBuild(indexPath, store)) {
+        std::cerr << "❌ Error: cannot build " << indexPath << "\n";
+        return 1;
+    }
+    std::cout << "🗂️ " << indexPath << ": " << index.size() << " blocks from height " << index.minHeight() << " ["
+              << msSince(start) << " ms]\n";
+
+    if (!hashHex.empty()) {
+        uint8_t hash[32];
+        if (hashHex.size() != 64 || !hexDecode(hashHex, hash)) {
+            std::cerr << "❌ --hash must be 64 hex characters\n";
+            return 1;
+        }
+        uint64_t row = index.rowOf(hash);
+        if (row == kNoRow) {
+            std::cout << "❔ " << hashHex << " is not in " << storePath << "\n";
+            return 1;
+        }
+        printRow(store, row);
+        return 0;
+    }
+
+    if (height >= 0) {
+        uint64_t row = height <= UINT32_MAX ? index.rowAt(static_cast<uint32_t>(height)) : kNoRow;
+        if (row == kNoRow) {
+            std::cout << "❔ No block at height " << height << " in " << storePath << "\n";
+            return 1;
+        }
+        printRow(store, row);
+        return 0;
+    }
+
+    if (!joinPath.empty()) {
+        std::ifstream in(joinPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << joinPath << " not found.\n";
+            return 1;
+        }
+        size_t entries = 0, matched = 0;
+        int64_t lo = INT64_MAX, hi = -1;
+        std::string error;
+        auto joinStart = std::chrono::steady_clock::now();
+        bool ok = streamMidstates(in, [&](MidstateRecord&& m) {
+            ++entries;
+            uint8_t hash[32];
+            uint32_t h;
+            if (m.blockhash.size() != 64 || !hexDecode(m.blockhash, hash) || !index.heightOf(hash, h)) return;
+            ++matched;
+            lo = std::min<int64_t>(lo, h);
+            hi = std::max<int64_t>(hi, h);
+        }, &error);
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << joinPath << ": " << error << "\n";
+            return 1;
+        }
+        std::cout << "🔗 Joined " << matched << " of " << entries << " entries by block hash";
+        if (matched) std::cout << ", heights " << lo << ".." << hi;
+        std::cout << " [" << msSince(joinStart) << " ms]\n";
+        return 0;
+    }
+
+    // Self-check: every real row must come back by hash and by height
+    size_t real = 0, mismatches = 0;
+    auto hashStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store[i].flags & kStoreSynthetic) continue;
+        ++real;
+        uint64_t row = index.rowOf(store[i].blockhash);
+        mismatches += row == kNoRow || std::memcmp(store[row].blockhash, store[i].blockhash, 32) != 0;
+    }
+    double hashMs = msSince(hashStart);
+
+    auto heightStart = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store[i].flags & kStoreSynthetic) continue;
+        uint64_t row = index.rowAt(store[i].height);
+        mismatches += row == kNoRow || store[row].height != store[i].height;
+    }
+    double heightMs = msSince(heightStart);
+
+    std::cout << "🔎 " << real << " lookups by hash: " << (real ? hashMs * 1e6 / real : 0.0) << " ns each, by height: "
+              << (real ? heightMs * 1e6 / real : 0.0) << " ns each\n";
+    if (mismatches) {
+        std::cerr << "❌ " << mismatches << " lookups failed\n";
+        return 1;
+    }
+    std::cout << "✅ Every real row found by hash and height\n";
+    return 0;
+}
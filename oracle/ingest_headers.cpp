@@ -0,0 +1,128 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "header_ingest.hpp"
+#include "oracle_store.hpp"
+#include "oracle_utils.hpp"
+
+// Builds the oracle midstate store straight from local header data, no RPC:
+//
+//   ingest_headers --blocks ~/.bitcoin/blocks [--store oracle/midstates.bin] [--truncate]
+//   ingest_headers --raw headers.bin [--start-height H] [--store oracle/midstates.bin] [--truncate]
+//
+// --blocks links the headers found in blk*.dat into the most-work chain;
+// --raw takes a flat file of consecutive 80-byte headers in chain order.
+// Heights already in the store are skipped, so reruns only append.
+
+// Records converted and appended per batch
+constexpr size_t kBatchSize = 65536;
+
+int main(int argc, char** argv) {
+    std::string blocksDir;
+    std::string rawPath;
+    std::string storePath = "oracle/midstates.bin";
+    int64_t startHeight = 0;
+    bool truncate = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--blocks" && hasValue) blocksDir = argv[++i];
+        else if (arg == "--raw" && hasValue) rawPath = argv[++i];
+        else if (arg == "--store" && hasValue) storePath = argv[++i];
+        else if (arg == "--start-height" && hasValue) startHeight = std::stoll(argv[++i]);
+        else if (arg == "--truncate") truncate = true;
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (blocksDir.empty() == rawPath.empty()) {
+        std::cerr << "❌ Pass exactly one of --blocks <dir> or --raw <file>\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<RawHeader> headers;
+    bool loaded = blocksDir.empty() ? readRawHeaderFile(rawPath, headers) : scanBlockFiles(blocksDir, headers);
+    if (!loaded) {
+        std::cerr << "❌ Error: cannot read " << (blocksDir.empty() ? rawPath : blocksDir) << "\n";
+        return 1;
+    }
+    std::cout << "📂 Read " << headers.size() << " headers [" << msSince(start) << " ms]\n";
+
+    std::vector<Hash256> hashes(headers.size());
+    hashHeaders(headers, hashes);
+
+    std::vector<uint32_t> chain;
+    if (!blocksDir.empty()) {
+        chain = bestChain(headers, hashes);
+        bool fromGenesis = !chain.empty() &&
+            std::all_of(headers[chain[0]].bytes + 4, headers[chain[0]].bytes + 36, [](uint8_t b) { return b == 0; });
+        if (!fromGenesis) {
+            std::cerr << "⚠️ Best chain does not start at genesis; heights are relative to its first header\n";
+        }
+        std::cout << "🔗 Best chain: " << chain.size() << " of " << headers.size()
+                  << " headers [" << msSince(start) << " ms]\n";
+    } else {
+        chain.resize(headers.size());
+        size_t broken = 0;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            chain[i] = static_cast<uint32_t>(i);
+            if (i > 0 && !std::equal(hashes[i - 1].begin(), hashes[i - 1].end(), headers[i].bytes + 4)) ++broken;
+        }
+        if (broken) std::cerr << "⚠️ " << broken << " headers do not link to their predecessor\n";
+    }
+
+    StoreWriter store;
+    if (!store.open(storePath, truncate)) {
+        std::cerr << "❌ Error: cannot open " << storePath << "\n";
+        return 1;
+    }
+
+    // Resume after the last stored real height; synthetic rows carry borrowed heights
+    int64_t storedTip = -1;
+    if (store.size() > 0) {
+        MappedStore mapped;
+        if (!mapped.open(storePath)) {
+            std::cerr << "❌ Error: cannot map " << storePath << "\n";
+            return 1;
+        }
+        for (size_t i = mapped.size(); i-- > 0;) {
+            if (mapped[i].flags & kStoreSynthetic) continue;
+            storedTip = mapped[i].height;
+            break;
+        }
+    }
+
+    size_t first = storedTip < startHeight ? 0 : static_cast<size_t>(storedTip - startHeight + 1);
+    size_t appended = 0;
+    std::vector<StoreRecord> records;
+    std::vector<Header80> batch;
+    for (size_t begin = first; begin < chain.size(); begin += kBatchSize) {
+        size_t end = std::min(chain.size(), begin + kBatchSize);
+        batch.resize(end - begin);
+        records.resize(end - begin);
+
+        for (size_t i = 0; i < batch.size(); ++i) batch[i] = headers[chain[begin + i]];
+        fillStoreRecords(batch, records);
+        for (size_t i = 0; i < records.size(); ++i) {
+            const Hash256& hash = hashes[chain[begin + i]];
+            std::reverse_copy(hash.begin(), hash.end(), records[i].blockhash);
+            records[i].height = static_cast<uint32_t>(startHeight + begin + i);
+        }
+
+        if (!store.append(records.data(), records.size()) || !store.flush()) {
+            std::cerr << "❌ Error: failed to append to " << storePath << "\n";
+            return 1;
+        }
+        appended += records.size();
+    }
+
+    std::cout << "✅ Appended " << appended << " midstates to " << storePath << " (" << store.size()
+              << " total) [" << msSince(start) << " ms]\n";
+    return 0;
+}
@@ -0,0 +1,65 @@
+// mapped_file.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            base = other.base;
+            length = other.length;
+            other.base = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+    ~MappedFile() { close(); }
+
+    // advice is passed to madvise(): sequential scans by default, MADV_RANDOM for lookups
+    bool open(const std::string& path, int advice = MADV_SEQUENTIAL) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st{};
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ok = false;
+            } else {
+                base = static_cast<const uint8_t*>(p);
+                length = static_cast<size_t>(st.st_size);
+                madvise(p, length, advice);
+            }
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    void close() {
+        if (base) munmap(const_cast<uint8_t*>(base), length);
+        base = nullptr;
+        length = 0;
+    }
+
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+};
@@ -0,0 +1,250 @@
+#include "midstate_batch.hpp"
+#include "parallel.hpp"
+#include "../hex_codec.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Lane helpers are internal; the by-value vector ABI note does not apply
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+namespace {
+
+// Eight 32-bit lanes; GCC/Clang lower this to AVX2 (or 2x SSE2) and 2x NEON
+typedef uint32_t u32x8 __attribute__((vector_size(32)));
+constexpr size_t kLanes = 8;
+
+// Groups below this many messages stay on the calling thread
+constexpr size_t kMinChunk = 2048;
+
+constexpr uint32_t kK[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr uint32_t kIV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// V is u32x8 (one message per lane) or uint32_t (a single message)
+template <typename V> inline V rotr(V x, int n) { return (x >> n) | (x << (32 - n)); }
+template <typename V> inline V bsig0(V x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
+template <typename V> inline V bsig1(V x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
+template <typename V> inline V ssig0(V x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3); }
+template <typename V> inline V ssig1(V x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10); }
+
+inline uint32_t loadBE(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline void storeBE(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline u32x8 splat(uint32_t v) {
+    return u32x8{v, v, v, v, v, v, v, v};
+}
+
+inline void loadIV(u32x8 s[8]) {
+    for (int i = 0; i < 8; ++i) s[i] = splat(kIV[i]);
+}
+
+// One SHA-256 compression in every lane. w holds the 16 message words and is
+// used as the rolling schedule, so it is clobbered.
+template <typename V>
+inline void compressLanes(V s[8], V w[16]) {
+    V a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; ++i) {
+        V wi;
+        if (i < 16) {
+            wi = w[i];
+        } else {
+            wi = ssig1(w[(i - 2) & 15]) + w[(i - 7) & 15] + ssig0(w[(i - 15) & 15]) + w[i & 15];
+            w[i & 15] = wi;
+        }
+        V t1 = h + bsig1(e) + ((e & f) ^ (~e & g)) + kK[i] + wi;
+        V t2 = bsig0(a) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+// Transposes up to 8 64-byte blocks (stride apart) into lane-major message words.
+// Missing lanes repeat the last block and are discarded by the caller.
+inline void loadBlocks(u32x8 w[16], const uint8_t* first, size_t stride, size_t lanes) {
+    for (size_t l = 0; l < kLanes; ++l) {
+        const uint8_t* p = first + std::min(l, lanes - 1) * stride;
+        for (int i = 0; i < 16; ++i) w[i][l] = loadBE(p + 4 * i);
+    }
+}
+
+// Runs fn(groupBegin, lanes) over [0, count) in groups of kLanes, across threads
+template <typename Fn>
+void forEachGroup(size_t count, Fn&& fn) {
+    size_t groups = (count + kLanes - 1) / kLanes;
+    parallelFor(groups, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) {
+            size_t base = g * kLanes;
+            fn(base, std::min(kLanes, count - base));
+        }
+    }, kMinChunk / kLanes);
+}
+
+} // namespace
+
+void computeMidstates(std::span<const Header80> headers, std::span<Midstate> out) {
+    forEachGroup(std::min(headers.size(), out.size()), [&](size_t base, size_t lanes) {
+        u32x8 s[8], w[16];
+        loadIV(s);
+        loadBlocks(w, headers[base].bytes, sizeof(Header80), lanes);
+        compressLanes(s, w);
+        for (size_t l = 0; l < lanes; ++l)
+            for (int i = 0; i < 8; ++i) out[base + l].h[i] = s[i][l];
+    });
+}
+
+void hashHeaders(std::span<const Header80> headers, std::span<Hash256> out) {
+    forEachGroup(std::min(headers.size(), out.size()), [&](size_t base, size_t lanes) {
+        u32x8 s[8], w[16];
+        loadIV(s);
+        loadBlocks(w, headers[base].bytes, sizeof(Header80), lanes);
+        compressLanes(s, w);
+
+        // Second block: header bytes 64..79, padding and the 640-bit length
+        for (size_t l = 0; l < kLanes; ++l) {
+            const uint8_t* p = headers[base + std::min(l, lanes - 1)].bytes + 64;
+            for (int i = 0; i < 4; ++i) w[i][l] = loadBE(p + 4 * i);
+        }
+        w[4] = splat(0x80000000);
+        for (int i = 5; i < 15; ++i) w[i] = splat(0);
+        w[15] = splat(640);
+        compressLanes(s, w);
+
+        // Outer hash of the 32-byte digest, which fits in one padded block
+        for (int i = 0; i < 8; ++i) w[i] = s[i];
+        w[8] = splat(0x80000000);
+        for (int i = 9; i < 15; ++i) w[i] = splat(0);
+        w[15] = splat(256);
+        loadIV(s);
+        compressLanes(s, w);
+
+        for (size_t l = 0; l < lanes; ++l)
+            for (int i = 0; i < 8; ++i) storeBE(out[base + l].data() + 4 * i, s[i][l]);
+    });
+}
+
+void hashHeader(const Header80& header, Hash256& out) {
+    uint32_t s[8], w[16];
+    std::copy(kIV, kIV + 8, s);
+    for (int i = 0; i < 16; ++i) w[i] = loadBE(header.bytes + 4 * i);
+    compressLanes(s, w);
+
+    for (int i = 0; i < 4; ++i) w[i] = loadBE(header.bytes + 64 + 4 * i);
+    w[4] = 0x80000000;
+    std::fill(w + 5, w + 15, 0u);
+    w[15] = 640;
+    compressLanes(s, w);
+
+    std::copy(s, s + 8, w);
+    w[8] = 0x80000000;
+    std::fill(w + 9, w + 15, 0u);
+    w[15] = 256;
+    std::copy(kIV, kIV + 8, s);
+    compressLanes(s, w);
+
+    for (int i = 0; i < 8; ++i) storeBE(out.data() + 4 * i, s[i]);
+}
+
+void sha256CompressBatch(std::span<Midstate> states, std::span<const uint8_t> blocks) {
+    forEachGroup(std::min(states.size(), blocks.size() / 64), [&](size_t base, size_t lanes) {
+        u32x8 s[8], w[16];
+        for (int i = 0; i < 8; ++i)
+            for (size_t l = 0; l < kLanes; ++l) s[i][l] = states[base + std::min(l, lanes - 1)].h[i];
+        loadBlocks(w, blocks.data() + base * 64, 64, lanes);
+        compressLanes(s, w);
+        for (size_t l = 0; l < lanes; ++l)
+            for (int i = 0; i < 8; ++i) states[base + l].h[i] = s[i][l];
+    });
+}
+
+void avalancheProfiles(std::span<const Header80> headers, std::span<AvalancheProfile> out) {
+    const size_t n = std::min(headers.size(), out.size());
+    std::vector<Midstate> midstates(n);
+    std::vector<Hash256> hashes(n);
+    computeMidstates(headers.first(n), midstates);
+    hashHeaders(headers.first(n), hashes);
+
+    // One group per flipped input byte; kHeaderBits is a multiple of kLanes
+    forEachGroup(n * kHeaderBits, [&](size_t base, size_t) {
+        const size_t h = base / kHeaderBits;
+        const size_t bit0 = base % kHeaderBits;
+        const uint8_t* header = headers[h].bytes;
+
+        // Bit b of the header is bit 31 - b % 32 of big-endian word b / 32
+        const size_t word = (bit0 % 512) / 32;
+        u32x8 flip;
+        for (size_t l = 0; l < kLanes; ++l) flip[l] = 1u << (31 - (bit0 + l) % 32);
+
+        u32x8 s[8], w[16];
+        if (bit0 < 512) {
+            loadIV(s);
+            for (int i = 0; i < 16; ++i) w[i] = splat(loadBE(header + 4 * i));
+            w[word] ^= flip;
+            compressLanes(s, w);
+        } else {
+            for (int i = 0; i < 8; ++i) s[i] = splat(midstates[h].h[i]);
+        }
+
+        // Second block: header bytes 64..79, padding and the 640-bit length
+        for (int i = 0; i < 4; ++i) w[i] = splat(loadBE(header + 64 + 4 * i));
+        if (bit0 >= 512) w[word] ^= flip;
+        w[4] = splat(0x80000000);
+        for (int i = 5; i < 15; ++i) w[i] = splat(0);
+        w[15] = splat(640);
+        compressLanes(s, w);
+
+        for (int i = 0; i < 8; ++i) w[i] = s[i];
+        w[8] = splat(0x80000000);
+        for (int i = 9; i < 15; ++i) w[i] = splat(0);
+        w[15] = splat(256);
+        loadIV(s);
+        compressLanes(s, w);
+
+        u32x8 diff[8];
+        for (int i = 0; i < 8; ++i) diff[i] = s[i] ^ splat(loadBE(hashes[h].data() + 4 * i));
+        for (size_t l = 0; l < kLanes; ++l) {
+            int d = 0;
+            for (int i = 0; i < 8; ++i) d += __builtin_popcount(diff[i][l]);
+            out[h][bit0 + l] = static_cast<uint16_t>(d);
+        }
+    });
+}
+
+void midstateToBytes(const Midstate& m, uint8_t out[32]) {
+    for (int i = 0; i < 8; ++i) storeBE(out + 4 * i, m.h[i]);
+}
+
+std::string midstateToHex(const Midstate& m) {
+    uint8_t bytes[32];
+    midstateToBytes(m, bytes);
+    return hexEncode(bytes, sizeof(bytes));
+}
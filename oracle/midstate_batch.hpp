@@ -0,0 +1,49 @@
+// midstate_batch.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Batched SHA-256 over block headers. Independent messages are packed into
+// vector lanes (8 per group, compiled to AVX2/SSE on x86 and NEON on arm64)
+// and groups are spread across threads.
+
+struct Header80 {
+    uint8_t bytes[80];
+};
+
+// Internal SHA-256 state after compressing header bytes 0..63
+struct Midstate {
+    uint32_t h[8];
+};
+
+using Hash256 = std::array<uint8_t, 32>;
+
+// Compresses the first 64 bytes of every header from the SHA-256 IV
+void computeMidstates(std::span<const Header80> headers, std::span<Midstate> out);
+
+// Double SHA-256 of every header, in internal byte order (reverse for display)
+void hashHeaders(std::span<const Header80> headers, std::span<Hash256> out);
+
+// Same for one header, without the lane and thread dispatch; for serial hash chains
+void hashHeader(const Header80& header, Hash256& out);
+
+// One compression round per message: states[i] = compress(states[i], blocks[i])
+void sha256CompressBatch(std::span<Midstate> states, std::span<const uint8_t> blocks);
+
+// Input bits of an 80-byte header
+constexpr size_t kHeaderBits = 640;
+
+// out[b] = Hamming distance between the double SHA-256 of a header and of
+// the same header with input bit b flipped (bit 7 - b % 8 of byte b / 8).
+using AvalancheProfile = std::array<uint16_t, kHeaderBits>;
+
+// Avalanche profile of every header. The 8 flips of one input byte share a
+// vector group; flips in bytes 64..79 restart from the header's midstate.
+void avalancheProfiles(std::span<const Header80> headers, std::span<AvalancheProfile> out);
+
+// Big-endian word bytes, the layout midstates.json uses
+void midstateToBytes(const Midstate& m, uint8_t out[32]);
+std::string midstateToHex(const Midstate& m);
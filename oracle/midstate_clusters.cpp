@@ -0,0 +1,81 @@
+#include "midstate_clusters.hpp"
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+namespace {
+
+constexpr char kClusterMagic[8] = {'O', 'R', 'C', 'L', 'C', 'L', 'U', '1'};
+constexpr uint32_t kClusterVersion = 1;
+
+struct ClusterHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t threshold;
+    uint64_t firstRow;
+    uint64_t rows;
+    uint32_t field;
+    uint32_t clusters;
+};
+
+} // namespace
+
+bool saveClusters(const std::string& path, const ClusterAssignment& assignment) {
+    std::string tmpPath = path + ".tmp";
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+
+    ClusterHeader h{};
+    std::memcpy(h.magic, kClusterMagic, sizeof(kClusterMagic));
+    h.version = kClusterVersion;
+    h.threshold = assignment.threshold;
+    h.firstRow = assignment.firstRow;
+    h.rows = assignment.cluster.size();
+    h.field = assignment.field;
+    h.clusters = assignment.clusters;
+
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(assignment.cluster.data(), sizeof(uint32_t), h.rows, f) == h.rows;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+DisjointSets::DisjointSets(size_t n) : parent(n), rank(n, 0) {
+    std::iota(parent.begin(), parent.end(), 0u);
+}
+
+uint32_t DisjointSets::find(uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+bool DisjointSets::unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (rank[a] < rank[b]) std::swap(a, b);
+    parent[b] = a;
+    if (rank[a] == rank[b]) ++rank[a];
+    return true;
+}
+
+uint32_t DisjointSets::labels(std::vector<uint32_t>& out) {
+    constexpr uint32_t kUnset = ~0u;
+    std::vector<uint32_t> idOfRoot(parent.size(), kUnset);
+    out.resize(parent.size());
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < parent.size(); ++i) {
+        uint32_t root = find(i);
+        if (idOfRoot[root] == kUnset) idOfRoot[root] = next++;
+        out[i] = idOfRoot[root];
+    }
+    return next;
+}
@@ -0,0 +1,36 @@
+// midstate_clusters.hpp
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cluster assignments for a contiguous range of store rows
+// (oracle/midstate_clusters.bin), written by cluster_midstates next to the
+// midstate store. cluster[i] belongs to store row firstRow + i; ids are
+// numbered in order of each cluster's first row.
+struct ClusterAssignment {
+    uint64_t firstRow = 0;
+    uint32_t threshold = 0;  // single-linkage cut, in bits
+    uint32_t field = 0;      // 0 = midstate, 1 = block hash
+    uint32_t clusters = 0;
+    std::vector<uint32_t> cluster;
+};
+
+bool saveClusters(const std::string& path, const ClusterAssignment& assignment);
+
+// Union-find over row indices, for single-linkage clustering
+class DisjointSets {
+public:
+    explicit DisjointSets(size_t n);
+
+    uint32_t find(uint32_t x);
+    // True if a and b were in different sets
+    bool unite(uint32_t a, uint32_t b);
+
+    // Dense set ids numbered by each set's first element
+    uint32_t labels(std::vector<uint32_t>& out);
+
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint8_t> rank;
+};
@@ -0,0 +1,145 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "hamming_index.hpp"
+#include "header_index.hpp"
+#include "midstate_stream.hpp"
+#include "oracle_store.hpp"
+#include "oracle_utils.hpp"
+
+// Nearest historical midstates by Hamming distance, as a candidate feature:
+//
+//   midstate_knn [--store oracle/midstates.bin] [--queries oracle/top_midstates.json] [--k 8]
+//                [--out oracle/midstate_knn.json]
+//
+// Without --queries every stored midstate is queried against the others
+// (leave-one-out). Output has the nearest and mean k-nearest distance per
+// query, and the query's own height when its block hash is in the store.
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string queriesPath;
+    std::string outPath = "oracle/midstate_knn.json";
+    size_t k = 8;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--queries") queriesPath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--k") k = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (k == 0) {
+        std::cerr << "❌ --k must be at least 1\n";
+        return 1;
+    }
+
+    MappedStore store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> history(store.size() * 32);
+    for (size_t i = 0; i < store.size(); ++i) std::copy(store[i].midstate, store[i].midstate + 32, &history[i * 32]);
+    HammingIndex index;
+    index.build(history.data(), store.size());
+    std::cout << "🗂️ Indexed " << index.size() << " midstates [" << msSince(start) << " ms]\n";
+
+    // Queries and their labels (block hash if known)
+    std::vector<uint8_t> queries;
+    std::vector<std::string> labels;
+    std::vector<int64_t> heights;  // -1 when the query's block is not in the store
+    bool selfQuery = queriesPath.empty();
+    if (selfQuery) {
+        queries = history;
+        for (size_t i = 0; i < store.size(); ++i) {
+            labels.push_back(hexEncode(store[i].blockhash, 32));
+            heights.push_back(store[i].flags & kStoreSynthetic ? -1 : int64_t(store[i].height));
+        }
+    } else {
+        // Join query block hashes to heights through the mmap'd header index
+        HeaderIndex headerIndex;
+        if (!headerIndex.openOrBuild(headerIndexPath(storePath), store))
+            std::cerr << "⚠️ No header index for " << storePath << "; query heights left out\n";
+        std::ifstream in(queriesPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << queriesPath << " not found.\n";
+            return 1;
+        }
+        std::string error;
+        bool ok = streamMidstates(in, [&](MidstateRecord&& m) {
+            uint8_t bytes[32];
+            if (m.midstate.size() != 64 || !hexDecode(m.midstate, bytes)) return;
+            queries.insert(queries.end(), bytes, bytes + 32);
+            uint8_t hash[32];
+            uint32_t height;
+            bool known = m.blockhash.size() == 64 && hexDecode(m.blockhash, hash) && headerIndex.heightOf(hash, height);
+            heights.push_back(known ? int64_t(height) : -1);
+            labels.push_back(std::move(m.blockhash));
+        }, &error);
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << queriesPath << ": " << error << "\n";
+            return 1;
+        }
+    }
+    size_t nq = labels.size();
+
+    // Leave-one-out asks for one extra neighbour: the query itself
+    size_t fetch = selfQuery ? k + 1 : k;
+    auto queryStart = std::chrono::steady_clock::now();
+    std::vector<Neighbor> neighbors;
+    index.knnBatch(queries.data(), nq, fetch, neighbors);
+    double queryMs = msSince(queryStart);
+    std::cout << "🔎 " << nq << " queries, k = " << k << " [" << queryMs << " ms, "
+              << (nq ? queryMs * 1000.0 / nq : 0.0) << " µs/query]\n";
+
+    JsonArrayWriter writer;
+    if (!writer.open(outPath)) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+
+    double nearestSum = 0.0;
+    for (size_t q = 0; q < nq; ++q) {
+        std::vector<Neighbor> found;
+        for (size_t j = 0; j < fetch && found.size() < k; ++j) {
+            const Neighbor& n = neighbors[q * fetch + j];
+            if (n.distance == UINT32_MAX || (selfQuery && n.id == q)) continue;
+            found.push_back(n);
+        }
+        if (found.empty()) continue;
+
+        double mean = 0.0;
+        for (const Neighbor& n : found) mean += n.distance;
+        mean /= found.size();
+        nearestSum += found[0].distance;
+
+        nlohmann::json row = {
+            {"blockhash", labels[q]},
+            {"midstate", hexEncode(&queries[q * 32], 32)},
+            {"nearest", found[0].distance},
+            {"nearest_height", store[found[0].id].height},
+            {"mean_distance", mean}
+        };
+        if (heights[q] >= 0) row["height"] = heights[q];
+        writer.write(row);
+    }
+
+    if (!writer.commit()) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "📊 Mean nearest distance " << (writer.size() ? nearestSum / writer.size() : 0.0) << " bits\n";
+    std::cout << "✅ Saved neighbour features to " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "midstate_set.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Table is kept at most half full
+constexpr size_t kMinSlots = 16;
+
+inline uint64_t keyWord(const uint8_t* midstate, int i) {
+    uint64_t v;
+    std::memcpy(&v, midstate + 8 * i, sizeof(v));
+    return v;
+}
+
+inline size_t slotsFor(size_t expected) {
+    size_t slots = kMinSlots;
+    while (slots < expected * 2) slots <<= 1;
+    return slots;
+}
+
+} // namespace
+
+MidstateBloom::MidstateBloom(size_t expected, unsigned bitsPerKey) {
+    size_t wanted = std::max<size_t>(64, expected * std::max(1u, bitsPerKey));
+    size_t n = 64;
+    while (n < wanted) n <<= 1;
+    bits.assign(n / 64, 0);
+    mask = n - 1;
+    probes = std::clamp(static_cast<unsigned>(std::lround(bitsPerKey * 0.693)), 1u, 16u);
+}
+
+// Double hashing from words 1 and 2; word 0 is left to the table
+void MidstateBloom::add(const uint8_t* midstate) {
+    uint64_t h1 = keyWord(midstate, 1);
+    uint64_t h2 = keyWord(midstate, 2) | 1;
+    for (unsigned i = 0; i < probes; ++i) {
+        uint64_t bit = (h1 + i * h2) & mask;
+        bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+}
+
+bool MidstateBloom::mayContain(const uint8_t* midstate) const {
+    uint64_t h1 = keyWord(midstate, 1);
+    uint64_t h2 = keyWord(midstate, 2) | 1;
+    for (unsigned i = 0; i < probes; ++i) {
+        uint64_t bit = (h1 + i * h2) & mask;
+        if (!(bits[bit >> 6] & (uint64_t(1) << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+MidstateSet::MidstateSet(size_t expected, bool bloomFront) : useBloom(bloomFront) {
+    rehash(slotsFor(expected));
+}
+
+void MidstateSet::reserve(size_t expected) {
+    if (slotsFor(expected) > ctrl.size()) rehash(slotsFor(expected));
+}
+
+// Slot holding the key, or the empty slot where it would go
+size_t MidstateSet::find(const uint8_t* midstate, uint64_t hash, bool& found) const {
+    uint8_t tag = static_cast<uint8_t>(0x80 | (hash >> 57));
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        if (ctrl[i] == 0) {
+            found = false;
+            return i;
+        }
+        if (ctrl[i] == tag && std::memcmp(keys[i].data(), midstate, 32) == 0) {
+            found = true;
+            return i;
+        }
+    }
+}
+
+bool MidstateSet::insert(const uint8_t* midstate) {
+    if ((count + 1) * 2 > ctrl.size()) rehash(ctrl.size() * 2);
+
+    uint64_t hash = keyWord(midstate, 0);
+    bool found = false;
+    size_t slot;
+    if (useBloom && !bloom.mayContain(midstate)) {
+        // Definitely new: take the first empty slot without comparing keys
+        slot = hash & mask;
+        while (ctrl[slot]) slot = (slot + 1) & mask;
+    } else {
+        slot = find(midstate, hash, found);
+        if (found) return false;
+    }
+
+    ctrl[slot] = static_cast<uint8_t>(0x80 | (hash >> 57));
+    std::memcpy(keys[slot].data(), midstate, 32);
+    if (useBloom) bloom.add(midstate);
+    ++count;
+    return true;
+}
+
+bool MidstateSet::contains(const uint8_t* midstate) const {
+    if (useBloom && !bloom.mayContain(midstate)) return false;
+    bool found = false;
+    find(midstate, keyWord(midstate, 0), found);
+    return found;
+}
+
+void MidstateSet::rehash(size_t slotCount) {
+    std::vector<MidstateKey> oldKeys(slotCount);
+    std::vector<uint8_t> oldCtrl(slotCount, 0);
+    oldKeys.swap(keys);
+    oldCtrl.swap(ctrl);
+    mask = slotCount - 1;
+
+    // Bloom is sized for the table's capacity and rebuilt with it
+    if (useBloom) bloom = MidstateBloom(slotCount / 2);
+
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+        if (!oldCtrl[i]) continue;
+        size_t slot = keyWord(oldKeys[i].data(), 0) & mask;
+        while (ctrl[slot]) slot = (slot + 1) & mask;
+        ctrl[slot] = oldCtrl[i];
+        keys[slot] = oldKeys[i];
+        if (useBloom) bloom.add(oldKeys[i].data());
+    }
+}
@@ -0,0 +1,63 @@
+// midstate_set.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Dedup of raw 32-byte midstates. Midstates are SHA-256 output, so their
+// bits are already uniform and the first 8 bytes are used directly as the
+// hash; no string keys, no per-entry allocation.
+
+using MidstateKey = std::array<uint8_t, 32>;
+
+// Bloom filter over midstates. The k probe positions come from the key's own
+// 64-bit words, so adding and testing needs no hashing.
+class MidstateBloom {
+public:
+    MidstateBloom() = default;
+    MidstateBloom(size_t expected, unsigned bitsPerKey = 10);
+
+    void add(const uint8_t* midstate);
+    bool mayContain(const uint8_t* midstate) const;
+    bool empty() const { return bits.empty(); }
+
+private:
+    std::vector<uint64_t> bits;
+    uint64_t mask = 0;
+    unsigned probes = 0;
+};
+
+// Open-addressing (linear probing) set of midstates. One control byte per
+// slot holds a 7-bit tag so most mismatching probes never touch the key.
+// With bloomFront, lookups of absent keys are usually answered by the Bloom
+// filter without touching the table, which helps once it outgrows the caches.
+class MidstateSet {
+public:
+    explicit MidstateSet(size_t expected = 0, bool bloomFront = false);
+
+    // True if the midstate was not in the set yet
+    bool insert(const uint8_t* midstate);
+    bool contains(const uint8_t* midstate) const;
+
+    size_t size() const { return count; }
+    void reserve(size_t expected);
+
+    // Visits every stored key, in slot order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < ctrl.size(); ++i)
+            if (ctrl[i]) fn(keys[i]);
+    }
+
+private:
+    size_t find(const uint8_t* midstate, uint64_t hash, bool& found) const;
+    void rehash(size_t slotCount);
+
+    std::vector<MidstateKey> keys;
+    std::vector<uint8_t> ctrl;  // 0 = empty, else 0x80 | 7 hash bits
+    size_t count = 0;
+    size_t mask = 0;
+    bool useBloom = false;
+    MidstateBloom bloom;
+};
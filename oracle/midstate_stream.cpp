@@ -0,0 +1,159 @@
+#include "midstate_stream.hpp"
+#include <cstdio>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Field setters for the record types below; unknown keys are ignored
+void assignNumber(HeaderRecord& r, const std::string& key, double, int64_t intVal, bool isInt) {
+    if (isInt && key == "height") r.height = intVal;
+}
+
+void assignString(HeaderRecord& r, const std::string& key, std::string&& val) {
+    if (key == "hash") r.hash = std::move(val);
+    else if (key == "header_hex") r.headerHex = std::move(val);
+}
+
+void assignNumber(MidstateRecord& r, const std::string& key, double val, int64_t, bool) {
+    if (key == "score") {
+        r.score = val;
+        r.hasScore = true;
+    }
+}
+
+void assignString(MidstateRecord& r, const std::string& key, std::string&& val) {
+    if (key == "blockhash") r.blockhash = std::move(val);
+    else if (key == "midstate") r.midstate = std::move(val);
+    else if (key == "tail") r.tail = std::move(val);
+}
+
+// SAX handler that assembles one top-level array element at a time
+template <typename Record>
+class ArraySax : public nlohmann::json_sax<json> {
+public:
+    explicit ArraySax(const std::function<void(Record&&)>& cb) : onRecord(cb) {}
+
+    std::string error;
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+
+    bool number_integer(number_integer_t val) override {
+        if (depth == 2) assignNumber(current, currentKey, static_cast<double>(val), val, true);
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        if (depth == 2)
+            assignNumber(current, currentKey, static_cast<double>(val), static_cast<int64_t>(val), true);
+        return true;
+    }
+
+    bool number_float(number_float_t val, const string_t&) override {
+        if (depth == 2) assignNumber(current, currentKey, val, 0, false);
+        return true;
+    }
+
+    bool string(string_t& val) override {
+        if (depth == 2) assignString(current, currentKey, std::move(val));
+        return true;
+    }
+
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override {
+        if (++depth == 2) current = Record{};
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth == 2) currentKey = val;
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth-- == 2) onRecord(std::move(current));
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = ex.what();
+        return false;
+    }
+
+private:
+    const std::function<void(Record&&)>& onRecord;
+    Record current;
+    std::string currentKey;
+    int depth = 0;
+};
+
+template <typename Record>
+bool streamArray(std::istream& in, const std::function<void(Record&&)>& onRecord, std::string* error) {
+    ArraySax<Record> sax(onRecord);
+    bool ok = json::sax_parse(in, &sax);
+    if (!ok && error) *error = sax.error;
+    return ok;
+}
+
+} // namespace
+
+bool streamHeaders(std::istream& in,
+                   const std::function<void(HeaderRecord&&)>& onHeader,
+                   std::string* error) {
+    return streamArray(in, onHeader, error);
+}
+
+bool streamMidstates(std::istream& in,
+                     const std::function<void(MidstateRecord&&)>& onMidstate,
+                     std::string* error) {
+    return streamArray(in, onMidstate, error);
+}
+
+JsonArrayWriter::~JsonArrayWriter() {
+    // Drop the partial file of an aborted run
+    if (!committed && !tmpPath.empty()) {
+        out.close();
+        std::remove(tmpPath.c_str());
+    }
+}
+
+bool JsonArrayWriter::open(const std::string& path) {
+    finalPath = path;
+    tmpPath = path + ".tmp";
+    count = 0;
+    committed = false;
+    out.open(tmpPath, std::ios::trunc);
+    return static_cast<bool>(out);
+}
+
+void JsonArrayWriter::write(const json& entry) {
+    std::string text = entry.dump(2);
+    std::string indented = count++ == 0 ? "[\n  " : ",\n  ";
+    indented.reserve(indented.size() + text.size() + text.size() / 8);
+    // Re-indent the element one level, as dump(2) does for array members
+    for (char c : text) {
+        indented += c;
+        if (c == '\n') indented += "  ";
+    }
+    out.write(indented.data(), static_cast<std::streamsize>(indented.size()));
+}
+
+bool JsonArrayWriter::commit() {
+    out << (count == 0 ? "[]" : "\n]");
+    out.close();
+    if (!out) return false;
+    committed = std::rename(tmpPath.c_str(), finalPath.c_str()) == 0;
+    return committed;
+}
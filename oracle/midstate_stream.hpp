@@ -0,0 +1,57 @@
+// midstate_stream.hpp
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+// One entry of oracle/block_headers.json
+struct HeaderRecord {
+    int64_t height = -1;
+    std::string hash;
+    std::string headerHex;
+};
+
+// Parse a block_headers.json array one entry at a time with a SAX reader,
+// calling onHeader for every object as soon as it closes. Only the current
+// entry is held in memory. Returns false (and sets error) on malformed JSON.
+bool streamHeaders(std::istream& in,
+                   const std::function<void(HeaderRecord&&)>& onHeader,
+                   std::string* error = nullptr);
+
+// One entry of oracle/midstates.json or oracle/top_midstates.json
+struct MidstateRecord {
+    std::string blockhash;
+    std::string midstate;
+    std::string tail;
+    double score = 0.0;
+    bool hasScore = false;
+};
+
+// Same as streamHeaders, for midstate arrays
+bool streamMidstates(std::istream& in,
+                     const std::function<void(MidstateRecord&&)>& onMidstate,
+                     std::string* error = nullptr);
+
+// Writes a JSON array incrementally, producing the same layout as
+// json::dump(2). Output goes to "<path>.tmp" and is renamed over path on
+// commit(), so a failed run never clobbers the previous file.
+class JsonArrayWriter {
+public:
+    ~JsonArrayWriter();
+
+    bool open(const std::string& path);
+    void write(const nlohmann::json& entry);
+    bool commit();
+
+    size_t size() const { return count; }
+
+private:
+    std::string finalPath;
+    std::string tmpPath;
+    std::ofstream out;
+    size_t count = 0;
+    bool committed = false;
+};
@@ -0,0 +1,94 @@
+#include "nonce_prior.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr uint64_t kNonceSpace = uint64_t(1) << 32;
+constexpr unsigned kMaxBinBits = 20;
+
+} // namespace
+
+NoncePrior::NoncePrior(unsigned bits)
+    : binBits(std::min(bits, kMaxBinBits)), counts(size_t(1) << binBits, 0) {}
+
+void NoncePrior::add(uint32_t nonce) {
+    ++counts[binOf(nonce)];
+    ++headers;
+}
+
+double NoncePrior::density(size_t bin) const {
+    return (counts[bin] + 1.0) / (headers + static_cast<double>(bins()));
+}
+
+uint32_t headerNonce(const uint8_t* header80) {
+    return uint32_t(header80[76]) | (uint32_t(header80[77]) << 8) | (uint32_t(header80[78]) << 16) |
+           (uint32_t(header80[79]) << 24);
+}
+
+bool saveNoncePrior(const std::string& path, const NoncePrior& prior) {
+    json j = {
+        {"bin_bits", prior.binBits},
+        {"headers", prior.headers},
+        {"counts", prior.counts}
+    };
+    std::ofstream out(path);
+    out << j.dump(2);
+    return static_cast<bool>(out);
+}
+
+bool loadNoncePrior(const std::string& path, NoncePrior& prior) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    try {
+        json j;
+        in >> j;
+        NoncePrior loaded(j.at("bin_bits").get<unsigned>());
+        auto counts = j.at("counts").get<std::vector<uint64_t>>();
+        if (counts.size() != loaded.bins()) {
+            std::cerr << "[ERROR] Nonce prior " << path << " has " << counts.size() << " bins, expected "
+                      << loaded.bins() << std::endl;
+            return false;
+        }
+        loaded.counts = std::move(counts);
+        loaded.headers = std::accumulate(loaded.counts.begin(), loaded.counts.end(), uint64_t(0));
+        prior = std::move(loaded);
+        return true;
+    } catch (const json::exception& e) {
+        std::cerr << "[ERROR] Malformed nonce prior " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+NonceSchedule::NonceSchedule() : shift(32), order{0}, rank{0} {}
+
+NonceSchedule::NonceSchedule(const NoncePrior& prior)
+    : shift(prior.binShift()), order(prior.bins()), rank(prior.bins()) {
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return prior.counts[a] > prior.counts[b];
+    });
+    for (uint32_t r = 0; r < order.size(); ++r) rank[order[r]] = r;
+}
+
+uint32_t NonceSchedule::nonceAt(uint64_t position) const {
+    position %= kNonceSpace;
+    uint64_t offset = position & ((uint64_t(1) << shift) - 1);
+    return static_cast<uint32_t>((uint64_t(order[position >> shift]) << shift) | offset);
+}
+
+uint64_t NonceSchedule::positionOf(uint32_t nonce) const {
+    uint64_t offset = nonce & ((uint64_t(1) << shift) - 1);
+    return (uint64_t(rank[uint64_t(nonce) >> shift]) << shift) | offset;
+}
+
+uint64_t NonceSchedule::runLength(uint64_t position) const {
+    position %= kNonceSpace;
+    return (uint64_t(1) << shift) - (position & ((uint64_t(1) << shift) - 1));
+}
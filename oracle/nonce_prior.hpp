@@ -0,0 +1,59 @@
+// nonce_prior.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Density prior over the 32-bit nonce space, from the winning nonces of real
+// headers. Miner firmware splits the space unevenly, so winning nonces
+// cluster in some ranges. The space is cut into 2^binBits equal bins.
+struct NoncePrior {
+    unsigned binBits = 8;
+    uint64_t headers = 0;
+    std::vector<uint64_t> counts;  // winning nonces per bin
+
+    explicit NoncePrior(unsigned bits = 8);
+
+    size_t bins() const { return counts.size(); }
+    unsigned binShift() const { return 32 - binBits; }
+    size_t binOf(uint32_t nonce) const { return nonce >> binShift(); }
+
+    void add(uint32_t nonce);
+
+    // Smoothed share of winning nonces in a bin (add-one)
+    double density(size_t bin) const;
+};
+
+// Header bytes 76..79, little-endian
+uint32_t headerNonce(const uint8_t* header80);
+
+// Writes {bin_bits, headers, counts} as JSON
+bool saveNoncePrior(const std::string& path, const NoncePrior& prior);
+
+// Returns false if the file is missing or malformed
+bool loadNoncePrior(const std::string& path, NoncePrior& prior);
+
+// Order in which to sweep the nonce space: bins by descending prior density
+// (ties by bin index, so an empty prior gives the sequential sweep), each bin
+// swept upwards. Sweep position p maps to exactly one nonce and back, so
+// positions 0 .. 2^32 - 1 cover the space once with no repeats.
+class NonceSchedule {
+public:
+    NonceSchedule();  // sequential sweep
+    explicit NonceSchedule(const NoncePrior& prior);
+
+    uint32_t nonceAt(uint64_t position) const;
+    uint64_t positionOf(uint32_t nonce) const;
+
+    // Nonces left in the bin that holds `position`: a batch of at most this
+    // many starting there is one contiguous nonce range
+    uint64_t runLength(uint64_t position) const;
+
+    const std::vector<uint32_t>& binOrder() const { return order; }
+
+private:
+    unsigned shift = 32;
+    std::vector<uint32_t> order;  // sweep rank -> bin
+    std::vector<uint32_t> rank;   // bin -> sweep rank
+};
@@ -0,0 +1,61 @@
+#include "npy_writer.hpp"
+#include <cstring>
+
+namespace {
+
+// Magic, version, header length and dict; a multiple of 64 keeps the data aligned
+constexpr size_t kHeaderBytes = 128;
+
+} // namespace
+
+NpyWriter::~NpyWriter() {
+    // Drop the partial file of an aborted run
+    if (file) std::fclose(file);
+    if (!committed && !tmpPath.empty()) std::remove(tmpPath.c_str());
+}
+
+bool NpyWriter::open(const std::string& path, const std::string& descr, size_t rowElements, size_t elementSize) {
+    finalPath = path;
+    tmpPath = path + ".tmp";
+    dtype = descr;
+    width = rowElements;
+    rowBytes = (rowElements ? rowElements : 1) * elementSize;
+    count = 0;
+    committed = false;
+
+    file = std::fopen(tmpPath.c_str(), "wb");
+    return file && writeHeader();
+}
+
+bool NpyWriter::writeHeader() {
+    std::string shape = std::to_string(count) + (width ? ", " + std::to_string(width) + ")" : ",)");
+    std::string dict = "{'descr': '" + dtype + "', 'fortran_order': False, 'shape': (" + shape + ", }";
+
+    char header[kHeaderBytes];
+    std::memset(header, ' ', sizeof(header));
+    const size_t prefix = 10;  // magic (6), version (2), header length (2)
+    if (prefix + dict.size() + 1 > sizeof(header)) return false;
+    std::memcpy(header, "\x93NUMPY\x01\x00", 8);
+    header[8] = static_cast<char>((kHeaderBytes - prefix) & 0xFF);
+    header[9] = static_cast<char>((kHeaderBytes - prefix) >> 8);
+    std::memcpy(header + prefix, dict.data(), dict.size());
+    header[kHeaderBytes - 1] = '\n';
+
+    return std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+bool NpyWriter::append(const void* rows, size_t n) {
+    if (!file) return false;
+    if (std::fwrite(rows, rowBytes, n, file) != n) return false;
+    count += n;
+    return true;
+}
+
+bool NpyWriter::commit() {
+    if (!file) return false;
+    bool ok = writeHeader() && std::fflush(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    committed = ok && std::rename(tmpPath.c_str(), finalPath.c_str()) == 0;
+    return committed;
+}
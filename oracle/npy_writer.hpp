@@ -0,0 +1,35 @@
+// npy_writer.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Streams rows into a NumPy .npy file (format 1.0, C order) that
+// np.load(path, mmap_mode="r") maps without parsing. The header is written
+// with room to spare and patched with the final row count on commit().
+// Like JsonArrayWriter, data goes to "<path>.tmp" and is renamed on commit().
+class NpyWriter {
+public:
+    ~NpyWriter();
+
+    // descr is the NumPy dtype string ("<f4", "|u1"); rowElements is the
+    // row width, 0 for a 1-D array
+    bool open(const std::string& path, const std::string& descr, size_t rowElements, size_t elementSize);
+    bool append(const void* rows, size_t n);
+    bool commit();
+
+    uint64_t rows() const { return count; }
+
+private:
+    bool writeHeader();
+
+    std::string finalPath;
+    std::string tmpPath;
+    std::string dtype;
+    FILE* file = nullptr;
+    size_t width = 0;
+    size_t rowBytes = 0;
+    uint64_t count = 0;
+    bool committed = false;
+};
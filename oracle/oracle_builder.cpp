@@ -3,19 +3,43 @@
 #include <vector>
 #include <string>
 #include <nlohmann/json.hpp>
-#include "sha256_wrapper.hpp"
+#include "../hex_codec.hpp"
+#include "midstate_batch.hpp"
+#include "midstate_stream.hpp"
+#include "parallel.hpp"
 
 using json = nlohmann::json;
 
-// Utility: Convert hex string to bytes
-std::vector<uint8_t> hex_to_bytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        std::string byteString = hex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(strtol(byteString.c_str(), nullptr, 16));
-        bytes.push_back(byte);
+// Headers processed per parallel batch; bounds memory independent of input size
+constexpr size_t kBatchSize = 8192;
+
+// Computes midstates for a batch in parallel and appends them to the output in input order
+void flushBatch(std::vector<HeaderRecord>& batch, JsonArrayWriter& writer) {
+    std::vector<Header80> headers(batch.size());
+    std::vector<char> valid(batch.size(), 0);
+
+    parallelFor(batch.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            // ✅ Use only the first 64 bytes of the 80-byte block header
+            std::string_view hex = batch[i].headerHex;
+            valid[i] = hex.size() >= 128 && hexDecode(hex.substr(0, 128), headers[i].bytes);
+        }
+    }, 256);
+
+    std::vector<Midstate> midstates(batch.size());
+    computeMidstates(headers, midstates);
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!valid[i]) {
+            std::cerr << "⚠️ Skipping entry with header size less than 64 bytes\n";
+            continue;
+        }
+        writer.write({
+            {"blockhash", batch[i].hash},
+            {"midstate", midstateToHex(midstates[i])}
+        });
     }
-    return bytes;
+    batch.clear();
 }
 
 int main() {
@@ -25,55 +49,43 @@ int main() {
         return 1;
     }
 
-    json headers_json;
-    inFile >> headers_json;
-    std::cout << "Loaded " << headers_json.size() << " entries from block_headers.json\n";
+    JsonArrayWriter writer;
+    if (!writer.open("oracle/midstates.json")) {
+        std::cerr << "❌ Error: Unable to open oracle/midstates.json for writing.\n";
+        return 1;
+    }
 
-    json output_json = json::array();  // Initialize as JSON array
+    std::vector<HeaderRecord> batch;
+    batch.reserve(kBatchSize);
+    size_t loaded = 0;
 
-    for (const auto& entry : headers_json) {
-        if (!entry.contains("header_hex")) {
+    std::string error;
+    bool ok = streamHeaders(inFile, [&](HeaderRecord&& entry) {
+        ++loaded;
+        if (entry.headerHex.empty()) {
             std::cerr << "⚠️ Skipping entry without 'header_hex'\n";
-            continue;
+            return;
         }
-        if (!entry.contains("hash")) {
+        if (entry.hash.empty()) {
             std::cerr << "⚠️ Skipping entry without 'hash'\n";
-            continue;
-        }
-
-        std::string hex_header = entry["header_hex"];
-        std::string blockhash = entry["hash"];
-
-        std::vector<uint8_t> raw = hex_to_bytes(hex_header);
-        if (raw.size() < 64) {
-            std::cerr << "⚠️ Skipping entry with header size less than 64 bytes\n";
-            continue;
+            return;
         }
+        batch.push_back(std::move(entry));
+        if (batch.size() == kBatchSize) flushBatch(batch, writer);
+    }, &error);
 
-        // ✅ Use only the first 64 bytes of the 80-byte block header
-        std::vector<uint8_t> first64(raw.begin(), raw.begin() + 64);
-
-        std::string midstate_hex;
-        try {
-            midstate_hex = compute_sha256_midstate_hex(first64.data(), first64.size());
-        } catch (const std::exception& e) {
-            std::cerr << "❌ Error computing midstate: " << e.what() << "\n";
-            continue;
-        }
-
-        output_json.push_back({
-            {"blockhash", blockhash},
-            {"midstate", midstate_hex}
-        });
+    if (!ok) {
+        std::cerr << "❌ Error: failed to parse oracle/block_headers.json: " << error << "\n";
+        return 1;
     }
+    flushBatch(batch, writer);
+    std::cout << "Loaded " << loaded << " entries from block_headers.json\n";
 
-    std::ofstream outFile("oracle/midstates.json");
-    if (!outFile) {
+    if (!writer.commit()) {
         std::cerr << "❌ Error: Unable to open oracle/midstates.json for writing.\n";
         return 1;
     }
-    outFile << output_json.dump(2);
 
-    std::cout << "✅ Saved " << output_json.size() << " midstates to oracle/midstates.json\n";
+    std::cout << "✅ Saved " << writer.size() << " midstates to oracle/midstates.json\n";
     return 0;
 }
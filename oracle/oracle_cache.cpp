@@ -0,0 +1,196 @@
+#include "oracle_cache.hpp"
+#include "mapped_file.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr char kCacheMagic[8] = {'O', 'R', 'C', 'L', 'C', 'C', 'H', '1'};
+constexpr uint32_t kCacheVersion = 1;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowSize;
+    uint64_t inputsHash;
+    uint64_t weightsHash;
+    uint64_t configHash;
+    uint64_t outputHash;
+    uint64_t rows;
+    uint64_t textBytes;
+    uint64_t payloadHash;  // rows then text
+};
+
+// Fixed part of a row; its strings sit back to back in the text section
+struct CacheRow {
+    double score;
+    uint64_t textOffset;
+    uint32_t blockhashLength;
+    uint16_t midstateLength;
+    uint16_t tailLength;
+};
+static_assert(sizeof(CacheRow) == 24, "CacheRow layout is part of the file format");
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    return rotl(acc + input * kPrime2, 31) * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t lane) {
+    return (acc ^ round64(0, lane)) * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+uint64_t hash64(const void* data, size_t n, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + n;
+    uint64_t h;
+
+    if (n >= 32) {
+        // Four independent lanes over 32-byte stripes
+        uint64_t v1 = seed + kPrime1 + kPrime2, v2 = seed + kPrime2, v3 = seed, v4 = seed - kPrime1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+    h += n;
+
+    for (; p + 8 <= end; p += 8) h = rotl(h ^ round64(0, read64(p)), 27) * kPrime1 + kPrime4;
+    if (p + 4 <= end) {
+        h = rotl(h ^ (read32(p) * kPrime1), 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) h = rotl(h ^ (*p * kPrime5), 11) * kPrime1;
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool hashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    hash = hash64(file.data(), file.size());
+    return true;
+}
+
+bool saveOracleCache(const std::string& path, const OracleCache& cache) {
+    std::vector<CacheRow> rows;
+    std::string text;
+    rows.reserve(cache.rows.size());
+    for (const auto& r : cache.rows) {
+        if (r.midstate.size() > UINT16_MAX || r.tail.size() > UINT16_MAX || r.blockhash.size() > UINT32_MAX)
+            return false;
+        rows.push_back({r.score, text.size(), static_cast<uint32_t>(r.blockhash.size()),
+                        static_cast<uint16_t>(r.midstate.size()), static_cast<uint16_t>(r.tail.size())});
+        text += r.blockhash;
+        text += r.midstate;
+        text += r.tail;
+    }
+
+    CacheHeader h{};
+    std::memcpy(h.magic, kCacheMagic, sizeof(kCacheMagic));
+    h.version = kCacheVersion;
+    h.rowSize = sizeof(CacheRow);
+    h.inputsHash = cache.key.inputs;
+    h.weightsHash = cache.key.weights;
+    h.configHash = cache.key.config;
+    h.outputHash = cache.outputHash;
+    h.rows = rows.size();
+    h.textBytes = text.size();
+    h.payloadHash = hash64(text.data(), text.size(), hash64(rows.data(), rows.size() * sizeof(CacheRow)));
+
+    // Written beside the target and renamed over it, so a reader never sees half a cache
+    std::string tmpPath = path + ".tmp";
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(rows.data(), sizeof(CacheRow), rows.size(), f) == rows.size() &&
+              std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool loadOracleCache(const std::string& path, OracleCache& cache, bool headerOnly) {
+    cache = OracleCache{};
+
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    CacheHeader h{};
+    bool ok = file.size() >= sizeof(h);
+    if (ok) {
+        std::memcpy(&h, file.data(), sizeof(h));
+        ok = std::memcmp(h.magic, kCacheMagic, sizeof(kCacheMagic)) == 0 && h.version == kCacheVersion &&
+             h.rowSize == sizeof(CacheRow) &&
+             h.rows <= (file.size() - sizeof(h)) / sizeof(CacheRow) &&
+             file.size() == sizeof(h) + h.rows * sizeof(CacheRow) + h.textBytes;
+    }
+    if (ok && !headerOnly) {
+        const uint8_t* rowBytes = file.data() + sizeof(h);
+        const char* text = reinterpret_cast<const char*>(rowBytes + h.rows * sizeof(CacheRow));
+        ok = hash64(text, h.textBytes, hash64(rowBytes, h.rows * sizeof(CacheRow))) == h.payloadHash;
+        cache.rows.reserve(h.rows);
+        for (uint64_t i = 0; ok && i < h.rows; ++i) {
+            CacheRow r;
+            std::memcpy(&r, rowBytes + i * sizeof(CacheRow), sizeof(r));
+            uint64_t length = uint64_t(r.blockhashLength) + r.midstateLength + r.tailLength;
+            if (r.textOffset > h.textBytes || length > h.textBytes - r.textOffset) {
+                ok = false;
+                break;
+            }
+            const char* s = text + r.textOffset;
+            cache.rows.push_back({std::string(s, r.blockhashLength),
+                                  std::string(s + r.blockhashLength, r.midstateLength),
+                                  std::string(s + r.blockhashLength + r.midstateLength, r.tailLength), r.score});
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "[ERROR] Corrupt oracle cache: " << path << std::endl;
+        cache = OracleCache{};
+        return false;
+    }
+
+    cache.key = {h.inputsHash, h.weightsHash, h.configHash};
+    cache.outputHash = h.outputHash;
+    return true;
+}
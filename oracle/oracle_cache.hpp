@@ -0,0 +1,48 @@
+// oracle_cache.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary cache of the dispatcher's ranked output (oracle/oracle_cache.bin),
+// keyed by content hashes of everything the ranking depends on. A run whose
+// key matches reuses the cached rows instead of rescoring; any change to the
+// inputs, weights or options changes the key and the cache is rebuilt.
+
+// Bump when scoring changes in a way the key cannot see (features, tie-breaks).
+// 2: sketch-mode pattern scores use the rescanned maximum and are not clamped
+constexpr uint64_t kScorerRevision = 2;
+
+struct OracleCacheKey {
+    uint64_t inputs = 0;   // midstates.json, plus the sketch store if one is used
+    uint64_t weights = 0;  // oracle_weights.json, 0 if absent
+    uint64_t config = 0;   // options and kScorerRevision
+
+    bool operator==(const OracleCacheKey&) const = default;
+};
+
+struct CachedRank {
+    std::string blockhash;
+    std::string midstate;
+    std::string tail;
+    double score;
+};
+
+struct OracleCache {
+    OracleCacheKey key;
+    uint64_t outputHash = 0;  // hash of the top_midstates.json written from these rows
+    std::vector<CachedRank> rows;
+};
+
+// XXH64 of a buffer
+uint64_t hash64(const void* data, size_t n, uint64_t seed = 0);
+
+// XXH64 of a whole file, read through a memory mapping. Returns false if it cannot be opened.
+bool hashFile(const std::string& path, uint64_t& hash);
+
+bool saveOracleCache(const std::string& path, const OracleCache& cache);
+
+// Returns false if the file is missing, from another version or corrupt. With
+// headerOnly, only the key and output hash are read and rows stays empty.
+bool loadOracleCache(const std::string& path, OracleCache& cache, bool headerOnly = false);
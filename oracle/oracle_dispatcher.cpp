@@ -3,23 +3,26 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include "../entropy_metrics.hpp"
 #include "../entropy_filter.cpp"
+#include "../hex_codec.hpp"
 #include "oracle_table.hpp"
+#include "oracle_store.hpp"
+#include "midstate_set.hpp"
+#include "oracle_weights.hpp"
+#include "oracle_cache.hpp"
+#include "parallel.hpp"
+#include "quantile_sketch.hpp"
+#include "oracle_utils.hpp"
 
 using json = nlohmann::json;
 
-std::vector<uint8_t> hex_to_bytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        std::string byteString = hex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(strtol(byteString.c_str(), nullptr, 16));
-        bytes.push_back(byte);
-    }
-    return bytes;
-}
-
 struct ScoredMidstate {
     std::string blockhash;
     std::string midstate_hex;
@@ -27,7 +30,122 @@ struct ScoredMidstate {
     double score;
 };
 
-int main() {
+// Writes ranked rows to oracle/top_midstates.json, repeating them up to N
+// entries, and returns the hash of what was written
+bool writeTopMidstates(const std::vector<CachedRank>& ranked, size_t N, uint64_t& outputHash) {
+    json top_json = json::array();
+    for (const auto& s : ranked) {
+        top_json.push_back({
+            {"blockhash", s.blockhash},
+            {"midstate", s.midstate},
+            {"tail", s.tail},
+            {"score", s.score}
+        });
+    }
+
+    // Repeat top entries if fewer than N
+    while (top_json.size() < N && !top_json.empty()) {
+        for (size_t i = 0; i < top_json.size() && top_json.size() < N; ++i) {
+            top_json.push_back(top_json[i]);
+        }
+    }
+
+    std::string text = top_json.dump(2);
+    outputHash = hash64(text.data(), text.size());
+    std::ofstream outFile("oracle/top_midstates.json");
+    outFile << text;
+    return static_cast<bool>(outFile);
+}
+
+// Scores oracle/midstates.json and writes the best to oracle/top_midstates.json:
+//
+//   oracle_dispatcher [--sketch-mb N] [--prefix-bytes 1] [--sketch-store oracle/midstates.bin]
+//                     [--cache oracle/oracle_cache.bin | --cache none]
+//
+// The pattern column is the midstate's first-byte count over the max count.
+// --sketch-mb switches to a count-min sketch of N MB over the first
+// --prefix-bytes bytes, counted from the JSON or, with --sketch-store, from
+// every real row of the store.
+//
+// Scores feed a KLL quantile sketch; the top N are the rows above the
+// sketch's cutoff, so only those are sorted. Score quantiles and the sketch
+// go to oracle/score_quantiles.json, and the shift against the previous
+// run's sketch is reported.
+//
+// The ranking is cached under content hashes of midstates.json, the sketch
+// store, the weights and these options. When they match the cache, an
+// unchanged top_midstates.json is kept as is, or rewritten from the cached
+// rows, without scoring.
+int main(int argc, char** argv) {
+    size_t sketchMegabytes = 0;
+    size_t prefixBytes = 1;
+    std::string sketchStorePath;
+    std::string cachePath = "oracle/oracle_cache.bin";
+    const size_t N = 131072;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--sketch-mb") sketchMegabytes = std::stoul(argv[i + 1]);
+        else if (arg == "--prefix-bytes") prefixBytes = std::stoul(argv[i + 1]);
+        else if (arg == "--sketch-store") sketchStorePath = argv[i + 1];
+        else if (arg == "--cache") cachePath = argv[i + 1];
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (prefixBytes < 1 || prefixBytes > 8) {
+        std::cerr << "❌ --prefix-bytes must be 1..8\n";
+        return 1;
+    }
+    if (!sketchStorePath.empty() && sketchMegabytes == 0) sketchMegabytes = 64;
+    if (cachePath == "none") cachePath.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Cache key: content hashes of everything the ranking depends on
+    OracleCacheKey key;
+    if (!hashFile("oracle/midstates.json", key.inputs)) {
+        std::cerr << "❌ Error: oracle/midstates.json not found.\n";
+        return 1;
+    }
+    if (!sketchStorePath.empty()) {
+        uint64_t storeHash = 0;
+        if (!hashFile(sketchStorePath, storeHash)) {
+            std::cerr << "❌ Error: cannot map " << sketchStorePath << "\n";
+            return 1;
+        }
+        key.inputs = hash64(&storeHash, sizeof(storeHash), key.inputs);
+    }
+    hashFile("oracle/oracle_weights.json", key.weights);  // stays 0 without a weights file
+    const uint64_t options[] = {kScorerRevision, sketchMegabytes, prefixBytes, !sketchStorePath.empty(), N};
+    key.config = hash64(options, sizeof(options));
+
+    OracleCache cache;
+    if (!cachePath.empty() && loadOracleCache(cachePath, cache, true)) {
+        if (cache.key == key) {
+            uint64_t outputHash = 0;
+            if (hashFile("oracle/top_midstates.json", outputHash) && outputHash == cache.outputHash) {
+                std::cout << "♻️ Inputs unchanged, keeping oracle/top_midstates.json [" << msSince(start) << " ms]\n";
+                return 0;
+            }
+            if (loadOracleCache(cachePath, cache)) {
+                if (!writeTopMidstates(cache.rows, N, cache.outputHash)) {
+                    std::cerr << "❌ Error: Could not write to oracle/top_midstates.json\n";
+                    return 1;
+                }
+                if (!saveOracleCache(cachePath, cache)) std::cerr << "⚠️ Could not write " << cachePath << "\n";
+                std::cout << "♻️ Inputs unchanged, rewrote oracle/top_midstates.json from " << cachePath << " ["
+                          << msSince(start) << " ms]\n";
+                return 0;
+            }
+        } else {
+            std::cout << "🔄 Oracle cache is stale (" << (cache.key.inputs != key.inputs ? "inputs " : "")
+                      << (cache.key.weights != key.weights ? "weights " : "")
+                      << (cache.key.config != key.config ? "options " : "") << "changed), rescoring\n";
+        }
+    }
+
     std::ifstream inFile("oracle/midstates.json");
     if (!inFile) {
         std::cerr << "❌ Error: oracle/midstates.json not found.\n";
@@ -42,11 +160,41 @@ int main() {
         return 1;
     }
 
+    // Fitted weights from fit_weights if present, else 0.6 * entropy + 0.4 * pattern
+    OracleWeights weights;
+    if (!loadWeights("oracle/oracle_weights.json", weights)) {
+        std::cerr << "⚠️ Using default score weights\n";
+        weights = OracleWeights{};
+    }
+
     std::vector<ScoredMidstate> scored;
 
-    // Build histogram for all entries
-    MidstateHistogram hist = buildMidstateHistogram("oracle/midstates.json");
+    // Build histogram for all entries, exact or sketched
+    MidstateHistogram hist;
+    PrefixSketch sketch(prefixBytes, sketchMegabytes << 20);
+    if (sketchMegabytes == 0) {
+        hist = buildMidstateHistogram("oracle/midstates.json");
+    } else if (!sketchStorePath.empty()) {
+        MappedStore store;
+        if (!store.open(sketchStorePath)) {
+            std::cerr << "❌ Error: cannot map " << sketchStorePath << "\n";
+            return 1;
+        }
+        sketch = sketchStorePrefixes(store.data(), store.size(), false, prefixBytes, sketchMegabytes << 20);
+    } else {
+        sketch = buildMidstateSketch("oracle/midstates.json", prefixBytes, sketchMegabytes << 20);
+    }
+    if (sketchMegabytes) {
+        std::cout << "🧮 Prefix sketch: " << sketch.sketch().width() << " x " << sketch.sketch().depth()
+                  << ", " << sketch.sketch().total() << " prefixes, overcount <= " << sketch.sketch().errorBound()
+                  << " w.p. " << 1.0 - std::exp(-double(sketch.sketch().depth())) << "\n";
+    }
 
+    std::vector<uint8_t> midstateBytes;
+    std::vector<uint8_t> tailBytes;
+    std::vector<double> patternScores;
+    MidstateSet seen(mids_json.size());
+    size_t duplicates = 0;
     for (const auto& entry : mids_json) {
         if (!entry.contains("midstate") || !entry.contains("blockhash") || !entry.contains("tail")) {
             continue; // skip incomplete entries
@@ -58,54 +206,123 @@ int main() {
 
         if (midstate_hex.size() != 64 || tail_hex.size() < 8) continue; // sanity check
 
-        auto bytes = hex_to_bytes(midstate_hex);
-        auto bits = entropy::bytes_to_bits(bytes);
+        uint8_t bytes[32];
+        if (!hexDecode(midstate_hex, bytes)) continue;
+        if (!seen.insert(bytes)) {
+            ++duplicates; // score each midstate once
+            continue;
+        }
+        midstateBytes.insert(midstateBytes.end(), bytes, bytes + 32);
 
-        double entropy_val = entropy::shannon_entropy(bits);
-        double pattern_score = scoreByHistogram(midstate_hex, hist);
-        double final_score = 0.6 * entropy_val + 0.4 * pattern_score;
+        // Tail only feeds feature columns; short or malformed tails stay zero
+        uint8_t tail[16] = {};
+        if (!hexDecode(std::string_view(tail_hex).substr(0, std::min<size_t>(32, tail_hex.size() & ~size_t(1))), tail))
+            std::fill(std::begin(tail), std::end(tail), 0);
+        tailBytes.insert(tailBytes.end(), tail, tail + 16);
 
-        scored.push_back({blockhash, midstate_hex, tail_hex, final_score});
+        patternScores.push_back(sketchMegabytes ? sketch.score(bytes) : scoreByHistogram(midstate_hex, hist));
+        scored.push_back({blockhash, midstate_hex, tail_hex, 0.0});
     }
 
-    std::sort(scored.begin(), scored.end(), [](const ScoredMidstate& a, const ScoredMidstate& b) {
-        return a.score > b.score;
-    });
+    if (duplicates) {
+        std::cerr << "⚠️ Skipped " << duplicates << " duplicate midstates\n";
+    }
 
-    const int N = 131072;
-    json top_json = json::array();
+    // Feature columns for all midstates in one batch
+    std::vector<FeatureVector> features(scored.size());
+    computeFeatureRows(midstateBytes.data(), tailBytes.data(), patternScores.data(), scored.size(), features.data());
 
-    std::cout << "📊 Top " << N << " scored midstates:\n";
+    // Scores and a quantile sketch per chunk, merged in chunk order so the summary is reproducible
+    KllSketch scoreSketch;
+    std::map<size_t, KllSketch> chunkSketches;
+    std::mutex sketchMutex;
+    size_t nonFinite = 0;
+    parallelFor(scored.size(), [&](size_t begin, size_t end) {
+        KllSketch local;
+        size_t rejected = 0;
+        for (size_t i = begin; i < end; ++i) {
+            // A NaN or infinite score ranks last and stays out of the sketch
+            double score = weights.score(features[i]);
+            if (!std::isfinite(score)) {
+                score = std::numeric_limits<double>::lowest();
+                ++rejected;
+            } else {
+                local.add(score);
+            }
+            scored[i].score = score;
+        }
+        std::lock_guard<std::mutex> lock(sketchMutex);
+        chunkSketches.emplace(begin, std::move(local));
+        nonFinite += rejected;
+    }, 1 << 14);
+    for (const auto& [begin, local] : chunkSketches) scoreSketch.merge(local);
+    if (nonFinite) {
+        std::cerr << "⚠️ " << nonFinite << " midstates scored NaN or infinite and rank last\n";
+    }
 
-    for (int i = 0; i < std::min(N, static_cast<int>(scored.size())); ++i) {
-        const auto& s = scored[i];
-        if (i < 10) {
-            std::cout << "[" << i + 1 << "] " << s.blockhash << " | score: " << s.score << "\n";
+    // Rows at or above the sketched top-N cutoff, widened by the rank error
+    // (doubling if the sketch was unlucky), then sorted. Once the widened
+    // cutoff reaches the bottom of the sketch, every row is sorted.
+    std::vector<uint32_t> picked;
+    double slack = scoreSketch.normalizedRankError();
+    for (;;) {
+        double q = 1.0 - static_cast<double>(N) / std::max<uint64_t>(1, scoreSketch.count()) - slack;
+        picked.clear();
+        if (q <= 0.0 || scoreSketch.empty()) {
+            picked.resize(scored.size());
+            for (size_t i = 0; i < scored.size(); ++i) picked[i] = static_cast<uint32_t>(i);
+            break;
         }
+        double cutoff = scoreSketch.quantile(q);
+        for (size_t i = 0; i < scored.size(); ++i)
+            if (scored[i].score >= cutoff) picked.push_back(static_cast<uint32_t>(i));
+        if (picked.size() >= std::min(N, scored.size())) break;
+        slack = std::max(2 * slack, 1.0 / scoreSketch.count());  // an exact sketch has no rank error to double
+    }
 
-        top_json.push_back({
-            {"blockhash", s.blockhash},
-            {"midstate", s.midstate_hex},
-            {"tail", s.tail_hex},
-            {"score", s.score}
-        });
+    std::sort(picked.begin(), picked.end(), [&](uint32_t a, uint32_t b) {
+        return scored[a].score != scored[b].score ? scored[a].score > scored[b].score : a < b;
+    });
+    if (picked.size() > N) picked.resize(N);
+    std::cout << "✂️ Sorted " << picked.size() << " of " << scored.size() << " rows above the cutoff\n";
+
+    // Quantiles only cover finite scores; with none there is nothing to compare or save
+    KllSketch previous;
+    if (!scoreSketch.empty() && loadQuantileSummary("oracle/score_quantiles.json", previous) && !previous.empty()) {
+        // Largest gap between the two score CDFs, checked at the current quantiles
+        double shift = 0.0;
+        for (double x : scoreSketch.quantiles({0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99}))
+            shift = std::max(shift, std::fabs(scoreSketch.rank(x) - previous.rank(x)));
+        std::cout << "📈 Median score " << previous.quantile(0.5) << " -> " << scoreSketch.quantile(0.5)
+                  << ", max CDF shift " << shift << "\n";
+    }
+    if (!scoreSketch.empty() && !saveQuantileSummary("oracle/score_quantiles.json", scoreSketch)) {
+        std::cerr << "⚠️ Could not write oracle/score_quantiles.json\n";
     }
 
-    // Repeat top entries if fewer than N
-    while ((int)top_json.size() < N && !top_json.empty()) {
-        for (size_t i = 0; i < top_json.size() && (int)top_json.size() < N; ++i) {
-            top_json.push_back(top_json[i]);
+    std::cout << "📊 Top " << N << " scored midstates:\n";
+
+    std::vector<CachedRank> ranked;
+    ranked.reserve(picked.size());
+    for (size_t i = 0; i < picked.size(); ++i) {
+        const auto& s = scored[picked[i]];
+        if (i < 10) {
+            std::cout << "[" << i + 1 << "] " << s.blockhash << " | score: " << s.score << "\n";
         }
+        ranked.push_back({s.blockhash, s.midstate_hex, s.tail_hex, s.score});
     }
 
-    std::ofstream outFile("oracle/top_midstates.json");
-    if (!outFile) {
+    cache.key = key;
+    if (!writeTopMidstates(ranked, N, cache.outputHash)) {
         std::cerr << "❌ Error: Could not write to oracle/top_midstates.json\n";
         return 1;
     }
-
-    outFile << top_json.dump(2);
     std::cout << "✅ Saved top midstates to oracle/top_midstates.json\n";
 
+    cache.rows = std::move(ranked);
+    if (!cachePath.empty() && !saveOracleCache(cachePath, cache)) {
+        std::cerr << "⚠️ Could not write " << cachePath << "\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,189 @@
+#include "oracle_state.hpp"
+#include "entropy_batch.hpp"
+#include "entropy_tables.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kStateMagic[8] = {'O', 'R', 'C', 'L', 'S', 'T', 'A', '1'};
+constexpr uint32_t kStateVersion = 2;  // 2: synthetic rows flagged and left out of prefixCounts
+
+struct StateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rowSize;
+    uint64_t rows;
+    int64_t tipHeight;
+    uint64_t prefixCounts[256];
+};
+
+constexpr size_t kOnesValues = entropy::kBlockBits + 1;
+
+} // namespace
+
+bool loadState(const std::string& path, OracleState& state) {
+    state = OracleState{};
+
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return true;  // no state yet
+
+    StateHeader h{};
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 &&
+              std::memcmp(h.magic, kStateMagic, sizeof(kStateMagic)) == 0 &&
+              h.version == kStateVersion && h.rowSize == sizeof(FeatureRow);
+    if (ok) {
+        state.features.resize(h.rows);
+        ok = std::fread(state.features.data(), sizeof(FeatureRow), h.rows, f) == h.rows;
+    }
+    std::fclose(f);
+
+    if (!ok) {
+        std::cerr << "[ERROR] Corrupt or outdated oracle state: " << path << std::endl;
+        state = OracleState{};
+        return false;
+    }
+
+    state.rows = h.rows;
+    state.tipHeight = h.tipHeight;
+    std::copy(std::begin(h.prefixCounts), std::end(h.prefixCounts), state.prefixCounts.begin());
+    return true;
+}
+
+bool saveState(const std::string& path, const OracleState& state, uint64_t firstNewRow) {
+    FILE* f = firstNewRow > 0 ? std::fopen(path.c_str(), "r+b") : nullptr;
+    if (!f) {
+        f = std::fopen(path.c_str(), "w+b");
+        firstNewRow = 0;
+    }
+    if (!f) return false;
+
+    StateHeader h{};
+    std::memcpy(h.magic, kStateMagic, sizeof(kStateMagic));
+    h.version = kStateVersion;
+    h.rowSize = sizeof(FeatureRow);
+    h.rows = state.rows;
+    h.tipHeight = state.tipHeight;
+    std::copy(state.prefixCounts.begin(), state.prefixCounts.end(), h.prefixCounts);
+
+    // Append only the new feature rows, then publish them through the header
+    long offset = static_cast<long>(sizeof(StateHeader) + firstNewRow * sizeof(FeatureRow));
+    size_t newRows = state.rows - firstNewRow;
+    bool ok = ftruncate(fileno(f), offset) == 0 &&
+              std::fseek(f, offset, SEEK_SET) == 0 &&
+              std::fwrite(state.features.data() + firstNewRow, sizeof(FeatureRow), newRows, f) == newRows &&
+              std::fflush(f) == 0 &&
+              std::fseek(f, 0, SEEK_SET) == 0 &&
+              std::fwrite(&h, sizeof(h), 1, f) == 1;
+    return std::fclose(f) == 0 && ok;
+}
+
+size_t applyRecords(OracleState& state, const StoreRecord* records, size_t n) {
+    std::vector<uint8_t> midstates(n * entropy::kBlockBytes);
+    for (size_t i = 0; i < n; ++i)
+        std::memcpy(&midstates[i * entropy::kBlockBytes], records[i].midstate, entropy::kBlockBytes);
+
+    std::vector<entropy::BlockMetrics> metrics(n);
+    entropy::compute_block_metrics(midstates.data(), n, metrics.data());
+
+    size_t real = 0;
+    state.features.reserve(state.features.size() + n);
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t prefix = records[i].midstate[0];
+        bool synthetic = records[i].flags & kStoreSynthetic;
+        state.features.push_back({metrics[i].entropy, metrics[i].ones, prefix, synthetic});
+        if (synthetic) continue;
+        ++state.prefixCounts[prefix];
+        state.tipHeight = std::max<int64_t>(state.tipHeight, records[i].height);
+        ++real;
+    }
+    state.rows += n;
+    return real;
+}
+
+std::vector<RankedRow> rankTop(const OracleState& state, size_t limit, const OracleWeights& weights) {
+    constexpr size_t kCells = 256 * kOnesValues;
+    auto cellOf = [](const FeatureRow& f) { return f.prefix * kOnesValues + f.ones; };
+
+    uint64_t maxCount = *std::max_element(state.prefixCounts.begin(), state.prefixCounts.end());
+    if (maxCount == 0) return {};  // no real rows
+
+    // Counting sort of real rows into (prefix, popcount) cells, row order kept inside a cell
+    std::vector<uint32_t> cellStart(kCells + 1, 0);
+    for (const auto& f : state.features)
+        if (!f.synthetic) ++cellStart[cellOf(f) + 1];
+    for (size_t c = 0; c < kCells; ++c) cellStart[c + 1] += cellStart[c];
+
+    std::vector<uint32_t> order(cellStart[kCells]);
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (size_t r = 0; r < state.features.size(); ++r)
+        if (!state.features[r].synthetic) order[cursor[cellOf(state.features[r])]++] = static_cast<uint32_t>(r);
+
+    struct Cell {
+        uint32_t id;
+        double score;
+    };
+    std::vector<Cell> cells;
+    for (uint32_t c = 0; c < kCells; ++c) {
+        if (cellStart[c] == cellStart[c + 1]) continue;
+        uint32_t prefix = c / kOnesValues;
+        uint32_t ones = c % kOnesValues;
+        double pattern = static_cast<double>(state.prefixCounts[prefix]) / maxCount;
+        cells.push_back({c, weights.bias + weights.w[kColEntropy] * entropy::kBitEntropy<entropy::kBlockBits>[ones] +
+                                weights.w[kColPattern] * pattern});
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) {
+        return a.score != b.score ? a.score > b.score : a.id < b.id;
+    });
+
+    std::vector<RankedRow> top;
+    top.reserve(std::min<size_t>(limit, order.size()));
+    for (const auto& cell : cells) {
+        for (uint32_t i = cellStart[cell.id]; i < cellStart[cell.id + 1] && top.size() < limit; ++i)
+            top.push_back({order[i], cell.score});
+        if (top.size() == limit) break;
+    }
+    return top;
+}
+
+std::vector<RankedRow> scoreRealRows(const OracleState& state, const MappedStore& store, const OracleWeights& weights) {
+    double maxCount = static_cast<double>(*std::max_element(state.prefixCounts.begin(), state.prefixCounts.end()));
+    if (maxCount == 0) return {};  // no real rows
+
+    std::vector<uint32_t> rows;
+    for (size_t r = 0; r < std::min<size_t>(state.features.size(), store.size()); ++r)
+        if (!state.features[r].synthetic) rows.push_back(static_cast<uint32_t>(r));
+
+    const size_t n = rows.size();
+    std::vector<uint8_t> midstates(n * entropy::kBlockBytes), tails(n * 16);
+    std::vector<double> pattern(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(&midstates[i * entropy::kBlockBytes], store[rows[i]].midstate, entropy::kBlockBytes);
+        std::memcpy(&tails[i * 16], store[rows[i]].tail, 16);
+        pattern[i] = state.prefixCounts[state.features[rows[i]].prefix] / maxCount;
+    }
+
+    std::vector<FeatureVector> features(n);
+    computeFeatureRows(midstates.data(), tails.data(), pattern.data(), n, features.data());
+
+    std::vector<RankedRow> ranked(n);
+    parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ranked[i] = {rows[i], weights.score(features[i])};
+    });
+    return ranked;
+}
+
+std::vector<RankedRow> rankTopFitted(const OracleState& state, const MappedStore& store, size_t limit,
+                                     const OracleWeights& weights) {
+    std::vector<RankedRow> ranked = scoreRealRows(state, store, weights);
+    limit = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + limit, ranked.end(), [](const RankedRow& a, const RankedRow& b) {
+        return a.score != b.score ? a.score > b.score : a.row < b.row;
+    });
+    ranked.resize(limit);
+    return ranked;
+}
@@ -0,0 +1,58 @@
+// oracle_state.hpp
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "oracle_store.hpp"
+#include "oracle_weights.hpp"
+
+// Feature columns kept for every store row
+struct FeatureRow {
+    double entropy;      // bit entropy of the midstate
+    uint32_t ones;       // popcount of the midstate
+    uint16_t prefix;     // first midstate byte, the histogram bucket
+    uint16_t synthetic;  // kStoreSynthetic row: kept for row alignment, never counted or ranked
+};
+
+// Persistent oracle state (oracle/oracle_state.bin) that lives next to the
+// midstate store. New store rows are folded in with applyRecords() and
+// appended with saveState(), so an update costs time in the number of new
+// rows rather than the length of the history.
+struct OracleState {
+    uint64_t rows = 0;
+    int64_t tipHeight = -1;
+    std::array<uint64_t, 256> prefixCounts{};
+    std::vector<FeatureRow> features;
+};
+
+// Loads state; a missing file yields an empty state. Returns false on a corrupt file.
+bool loadState(const std::string& path, OracleState& state);
+
+// Persists rows [firstNewRow, rows) and the updated header
+bool saveState(const std::string& path, const OracleState& state, uint64_t firstNewRow);
+
+// Adds feature rows for records appended to the store, and histogram
+// counts for the real ones. Returns the number of real (not synthetic) records.
+size_t applyRecords(OracleState& state, const StoreRecord* records, size_t n);
+
+struct RankedRow {
+    uint32_t row;
+    double score;
+};
+
+// Best `limit` real rows by bias + w[entropy] * entropy + w[pattern] * count[prefix] / maxCount,
+// the score oracle_dispatcher computes when only those weights are set
+// (weights.entropyPatternOnly()). The score only depends on (prefix,
+// popcount), so rows are bucketed into those 256 x 257 cells and only the
+// cells are sorted.
+std::vector<RankedRow> rankTop(const OracleState& state, size_t limit, const OracleWeights& weights);
+
+// Full fitted score of every real row, in row order, over the same feature
+// columns computeFeatureRows() gives oracle_dispatcher. Empty if there are
+// no real rows. Costs a pass over every row of the store.
+std::vector<RankedRow> scoreRealRows(const OracleState& state, const MappedStore& store, const OracleWeights& weights);
+
+// Best `limit` rows of scoreRealRows()
+std::vector<RankedRow> rankTopFitted(const OracleState& state, const MappedStore& store, size_t limit,
+                                     const OracleWeights& weights);
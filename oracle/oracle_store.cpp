@@ -0,0 +1,136 @@
+#include "oracle_store.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool validHeader(const StoreHeader& h) {
+    return std::memcmp(h.magic, kStoreMagic, sizeof(kStoreMagic)) == 0 &&
+           h.version == kStoreVersion && h.recordSize == sizeof(StoreRecord);
+}
+
+} // namespace
+
+void fillStoreRecords(std::span<const Header80> headers, std::span<StoreRecord> out) {
+    size_t n = std::min(headers.size(), out.size());
+    std::vector<Midstate> midstates(n);
+    computeMidstates(headers.first(n), midstates);
+
+    for (size_t i = 0; i < n; ++i) {
+        StoreRecord& rec = out[i];
+        midstateToBytes(midstates[i], rec.midstate);
+        std::memcpy(rec.tail, headers[i].bytes + 64, sizeof(rec.tail));
+        std::memset(rec.blockhash, 0, sizeof(rec.blockhash));
+        rec.height = 0;
+        rec.flags = 0;
+    }
+}
+
+StoreWriter::~StoreWriter() {
+    close();
+}
+
+bool StoreWriter::open(const std::string& path, bool truncate) {
+    close();
+
+    if (!truncate) file = std::fopen(path.c_str(), "r+b");
+    if (file) {
+        if (std::fread(&header, sizeof(header), 1, file) != 1 || !validHeader(header)) {
+            std::cerr << "[ERROR] Not a midstate store: " << path << std::endl;
+            close();
+            return false;
+        }
+        // Drop any records written after the last header update
+        off_t end = static_cast<off_t>(sizeof(StoreHeader) + header.count * sizeof(StoreRecord));
+        if (ftruncate(fileno(file), end) != 0 || std::fseek(file, 0, SEEK_END) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    file = std::fopen(path.c_str(), "w+b");
+    if (!file) return false;
+    std::memcpy(header.magic, kStoreMagic, sizeof(kStoreMagic));
+    header.version = kStoreVersion;
+    header.recordSize = sizeof(StoreRecord);
+    header.count = 0;
+    return flush();
+}
+
+bool StoreWriter::append(const StoreRecord* records, size_t n) {
+    if (!file) return false;
+    if (n == 0) return true;
+    if (std::fwrite(records, sizeof(StoreRecord), n, file) != n) return false;
+    header.count += n;
+    return true;
+}
+
+bool StoreWriter::flush() {
+    if (!file) return false;
+    // Records must reach the file before the count that covers them
+    if (std::fflush(file) != 0) return false;
+    if (std::fseek(file, 0, SEEK_SET) != 0) return false;
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) return false;
+    if (std::fflush(file) != 0) return false;
+    return std::fseek(file, 0, SEEK_END) == 0;
+}
+
+void StoreWriter::close() {
+    if (!file) return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+MappedStore::~MappedStore() {
+    close();
+}
+
+bool MappedStore::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(StoreHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    mappedBytes = static_cast<size_t>(st.st_size);
+    base = mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        mappedBytes = 0;
+        return false;
+    }
+
+    const auto* header = static_cast<const StoreHeader*>(base);
+    size_t available = (mappedBytes - sizeof(StoreHeader)) / sizeof(StoreRecord);
+    if (!validHeader(*header) || header->count > available) {
+        std::cerr << "[ERROR] Not a midstate store: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    records = reinterpret_cast<const StoreRecord*>(static_cast<const uint8_t*>(base) + sizeof(StoreHeader));
+    count = header->count;
+    madvise(base, mappedBytes, MADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedStore::close() {
+    if (base) munmap(base, mappedBytes);
+    base = nullptr;
+    mappedBytes = 0;
+    records = nullptr;
+    count = 0;
+}
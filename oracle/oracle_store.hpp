@@ -0,0 +1,80 @@
+// oracle_store.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+#include "midstate_batch.hpp"
+
+// Binary midstate store (oracle/midstates.bin): a fixed header followed by
+// fixed-size records, appended in height order. Replaces re-parsing hex JSON
+// for tools that only need raw midstate bytes.
+
+constexpr char kStoreMagic[8] = {'O', 'R', 'C', 'L', 'S', 'T', 'R', '1'};
+constexpr uint32_t kStoreVersion = 1;
+
+// Record flags
+constexpr uint32_t kStoreSynthetic = 1u << 0;  // generated prefix, no real block behind it
+
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count;
+};
+
+struct StoreRecord {
+    uint8_t midstate[32];   // SHA-256 state after header bytes 0..63, big-endian words (as in midstates.json)
+    uint8_t tail[16];       // header bytes 64..79
+    uint8_t blockhash[32];  // block hash in display order, zero for synthetic rows
+    uint32_t height;
+    uint32_t flags;
+};
+static_assert(sizeof(StoreRecord) == 88, "StoreRecord layout is part of the file format");
+
+// Fills midstate and tail of out[i] from headers[i] with batched SHA-256.
+// height, blockhash and flags are zeroed for the caller to set.
+void fillStoreRecords(std::span<const Header80> headers, std::span<StoreRecord> out);
+
+// Appends records to a store, creating it if needed. The header count is
+// rewritten on flush(), and a torn tail from an interrupted run is truncated
+// away on open.
+class StoreWriter {
+public:
+    ~StoreWriter();
+
+    bool open(const std::string& path, bool truncate = false);
+    bool append(const StoreRecord* records, size_t n);
+    bool flush();
+    void close();
+
+    uint64_t size() const { return header.count; }
+
+private:
+    FILE* file = nullptr;
+    StoreHeader header{};
+};
+
+// Read-only memory mapping of a store. Records are accessed in place.
+class MappedStore {
+public:
+    MappedStore() = default;
+    MappedStore(const MappedStore&) = delete;
+    MappedStore& operator=(const MappedStore&) = delete;
+    ~MappedStore();
+
+    bool open(const std::string& path);
+    void close();
+
+    size_t size() const { return count; }
+    const StoreRecord* data() const { return records; }
+    const StoreRecord& operator[](size_t i) const { return records[i]; }
+
+private:
+    void* base = nullptr;
+    size_t mappedBytes = 0;
+    const StoreRecord* records = nullptr;
+    size_t count = 0;
+};
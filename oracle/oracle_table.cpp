@@ -1,4 +1,6 @@
 #include "oracle_table.hpp"
+#include "midstate_stream.hpp"
+#include "../hex_codec.hpp"
 #include <fstream>
 #include <iostream>      // Added this to fix std::cerr error
 #include <nlohmann/json.hpp>
@@ -38,3 +40,32 @@ double scoreByHistogram(const std::string& midstateHex, const MidstateHistogram&
 
     return static_cast<double>(it->second) / maxCount;
 }
+
+PrefixSketch buildMidstateSketch(const std::string& jsonPath, size_t prefixBytes, size_t memoryBytes) {
+    PrefixSketch sketch(prefixBytes, memoryBytes);
+    const size_t hexChars = 2 * sketch.prefixBytes();
+
+    // Calls fn(prefix) for every midstate up to the end of the file or the
+    // first parse error. Returns false if the file cannot be opened.
+    auto forEachPrefix = [&](auto&& fn, bool reportErrors) {
+        std::ifstream in(jsonPath);
+        if (!in) {
+            if (reportErrors) std::cerr << "[ERROR] Failed to open: " << jsonPath << std::endl;
+            return false;
+        }
+        std::string error;
+        bool ok = streamMidstates(in, [&](MidstateRecord&& m) {
+            uint8_t prefix[8];
+            if (m.midstate.size() < hexChars || !hexDecode(std::string_view(m.midstate).substr(0, hexChars), prefix)) return;
+            fn(prefix);
+        }, &error);
+        if (!ok && reportErrors) std::cerr << "[ERROR] Failed to parse " << jsonPath << ": " << error << std::endl;
+        return true;
+    };
+
+    // Later adds can raise earlier estimates, so the maximum comes from a
+    // second pass once counting is done rather than from keeping the prefixes
+    if (forEachPrefix([&](const uint8_t* prefix) { sketch.add(prefix); }, true))
+        forEachPrefix([&](const uint8_t* prefix) { sketch.rescanMax(prefix); }, false);
+    return sketch;
+}
@@ -2,6 +2,7 @@
 #pragma once
 #include <unordered_map>
 #include <string>
+#include "prefix_sketch.hpp"
 
 // Map: prefix (like "6b") → frequency count
 using MidstateHistogram = std::unordered_map<std::string, int>;
@@ -9,3 +10,8 @@ using MidstateHistogram = std::unordered_map<std::string, int>;
 // Function declarations
 MidstateHistogram buildMidstateHistogram(const std::string& jsonPath);
 double scoreByHistogram(const std::string& midstateHex, const MidstateHistogram& hist);
+
+// Approximate mode: count-min sketch over the first prefixBytes midstate
+// bytes, streamed from the JSON array so memory stays at memoryBytes. The
+// file is read twice: once to count, once to take the exact maxCount().
+PrefixSketch buildMidstateSketch(const std::string& jsonPath, size_t prefixBytes, size_t memoryBytes);
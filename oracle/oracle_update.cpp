@@ -0,0 +1,229 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "midstate_set.hpp"
+#include "midstate_stream.hpp"
+#include "oracle_state.hpp"
+#include "oracle_store.hpp"
+#include "oracle_weights.hpp"
+#include "parallel.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+
+// Incremental oracle refresh: appends headers newer than the stored tip to
+// oracle/midstates.bin, folds them into oracle/oracle_state.bin and re-ranks.
+//
+//   oracle_update [--headers oracle/block_headers.json] [--store oracle/midstates.bin]
+//                 [--state oracle/oracle_state.bin] [--out oracle/top_midstates.json] [--top N]
+
+// Headers converted per parallel batch
+constexpr size_t kBatchSize = 8192;
+
+int main(int argc, char** argv) {
+    std::string headersPath = "oracle/block_headers.json";
+    std::string storePath = "oracle/midstates.bin";
+    std::string statePath = "oracle/oracle_state.bin";
+    std::string outPath = "oracle/top_midstates.json";
+    size_t N = 131072;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--headers") headersPath = argv[i + 1];
+        else if (arg == "--store") storePath = argv[i + 1];
+        else if (arg == "--state") statePath = argv[i + 1];
+        else if (arg == "--out") outPath = argv[i + 1];
+        else if (arg == "--top") N = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    OracleState state;
+    if (!loadState(statePath, state)) {
+        std::cerr << "⚠️ Rebuilding oracle state from the store\n";
+    }
+
+    StoreWriter store;
+    if (!store.open(storePath)) {
+        std::cerr << "❌ Error: cannot open " << storePath << "\n";
+        return 1;
+    }
+
+    // Bring the state level with the store (first run, rows appended by other
+    // tools such as generate_synthetic, or a crash between the two writes)
+    uint64_t firstNewRow = state.rows;
+    size_t newHeaders = 0;  // real rows only; generate_synthetic rows are not headers
+    if (state.rows != store.size()) {
+        if (state.rows > store.size()) {
+            state = OracleState{};
+            firstNewRow = 0;
+        }
+        MappedStore mapped;
+        if (!mapped.open(storePath)) {
+            std::cerr << "❌ Error: cannot map " << storePath << "\n";
+            return 1;
+        }
+        newHeaders += applyRecords(state, mapped.data() + state.rows, mapped.size() - state.rows);
+    }
+
+    std::ifstream in(headersPath);
+    if (!in) {
+        std::cerr << "❌ Error: " << headersPath << " not found.\n";
+        return 1;
+    }
+
+    std::vector<HeaderRecord> batch;
+    batch.reserve(kBatchSize);
+    size_t skipped = 0;
+    bool storeOk = true;
+
+    auto flushBatch = [&] {
+        // Exports may list newest first; the store keeps each batch in height order
+        std::stable_sort(batch.begin(), batch.end(),
+                         [](const HeaderRecord& a, const HeaderRecord& b) { return a.height < b.height; });
+
+        std::vector<Header80> headers(batch.size());
+        std::vector<Hash256> hashes(batch.size());
+        std::vector<char> valid(batch.size(), 0);
+
+        parallelFor(batch.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                valid[i] = batch[i].headerHex.size() == 160 && batch[i].hash.size() == 64 &&
+                           hexDecode(batch[i].headerHex, headers[i].bytes) &&
+                           hexDecode(batch[i].hash, hashes[i].data());
+            }
+        }, 256);
+
+        std::vector<StoreRecord> records(batch.size());
+        fillStoreRecords(headers, records);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (!valid[i]) {
+                std::cerr << "⚠️ Skipping malformed header at height " << batch[i].height << "\n";
+                continue;
+            }
+            records[kept] = records[i];
+            std::memcpy(records[kept].blockhash, hashes[i].data(), 32);
+            records[kept].height = static_cast<uint32_t>(batch[i].height);
+            ++kept;
+        }
+        storeOk = storeOk && store.append(records.data(), kept);
+        newHeaders += applyRecords(state, records.data(), kept);
+        batch.clear();
+    };
+
+    // Only headers above the tip stored before this run are new, in any input
+    // order; older ones and repeated heights are skipped without hashing
+    const int64_t storedTip = state.tipHeight;
+    std::unordered_set<int64_t> heightsSeen;
+    std::string error;
+    bool ok = streamHeaders(in, [&](HeaderRecord&& h) {
+        if (h.height < 0 || h.headerHex.empty() || h.hash.empty()) {
+            std::cerr << "⚠️ Skipping entry without height, hash or header_hex\n";
+            return;
+        }
+        if (h.height <= storedTip || !heightsSeen.insert(h.height).second) {
+            ++skipped;
+            return;
+        }
+        batch.push_back(std::move(h));
+        if (batch.size() == kBatchSize) flushBatch();
+    }, &error);
+
+    if (!ok) {
+        std::cerr << "❌ Error: failed to parse " << headersPath << ": " << error << "\n";
+        return 1;
+    }
+    flushBatch();
+
+    if (!storeOk || !store.flush()) {
+        std::cerr << "❌ Error: failed to append to " << storePath << "\n";
+        return 1;
+    }
+    store.close();
+
+    if (!saveState(statePath, state, firstNewRow)) {
+        std::cerr << "❌ Error: failed to write " << statePath << "\n";
+        return 1;
+    }
+
+    std::cout << "📥 " << newHeaders << " new headers (" << skipped
+              << " already stored or repeated), tip height " << state.tipHeight
+              << " [" << msSince(start) << " ms]\n";
+
+    if (state.rows == 0) {
+        std::cerr << "❌ Error: oracle store is empty.\n";
+        return 1;
+    }
+
+    MappedStore mapped;
+    if (!mapped.open(storePath)) {
+        std::cerr << "❌ Error: cannot map " << storePath << "\n";
+        return 1;
+    }
+
+    // Same weights and score as oracle_dispatcher. Entropy and pattern alone
+    // rank by cell from the state; other fitted columns need a pass over the store.
+    auto rankStart = std::chrono::steady_clock::now();
+    OracleWeights weights;
+    if (!loadWeights("oracle/oracle_weights.json", weights)) weights = OracleWeights{};
+    bool cellRanked = weights.entropyPatternOnly();
+    std::vector<RankedRow> top = cellRanked ? rankTop(state, N, weights) : rankTopFitted(state, mapped, N, weights);
+    uint64_t realRows = std::accumulate(state.prefixCounts.begin(), state.prefixCounts.end(), uint64_t(0));
+    std::cout << "📊 Ranked " << realRows << " real midstates by " << (cellRanked ? "entropy and pattern" : "all fitted weights")
+              << " [" << msSince(rankStart) << " ms]\n";
+
+    // A block stored twice, by overlapping ingests, has one midstate; emit it once
+    MidstateSet seen(top.size());
+    size_t kept = 0;
+    for (const RankedRow& r : top) {
+        if (seen.insert(mapped[r.row].midstate)) top[kept++] = r;
+    }
+    if (kept < top.size()) {
+        std::cerr << "⚠️ Skipped " << top.size() - kept << " duplicate midstates\n";
+        top.resize(kept);
+    }
+    if (top.empty()) {
+        std::cerr << "❌ Error: oracle store has no real midstates to rank.\n";
+        return 1;
+    }
+
+    JsonArrayWriter writer;
+    if (!writer.open(outPath)) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+
+    // Repeat top entries if fewer than N, as oracle_dispatcher does
+    for (size_t i = 0; i < N; ++i) {
+        const RankedRow& r = top[i % top.size()];
+        const StoreRecord& rec = mapped[r.row];
+        writer.write({
+            {"blockhash", hexEncode(rec.blockhash, 32)},
+            {"midstate", hexEncode(rec.midstate, 32)},
+            {"tail", hexEncode(rec.tail, 16)},
+            {"score", r.score}
+        });
+    }
+
+    if (!writer.commit()) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+
+    std::cout << "✅ Saved top midstates to " << outPath << " [" << msSince(start) << " ms total]\n";
+    return 0;
+}
@@ -0,0 +1,32 @@
+// oracle_utils.hpp
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Milliseconds elapsed since start, for the timings oracle tools report
+inline double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// SplitMix64: advances state and returns 64 well-mixed bits. Fast and
+// reproducible from a seed, not for anything adversarial.
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Leading zero bits of a display-order hash
+inline double leadingZeroBits(const uint8_t* hash) {
+    int bits = 0;
+    for (int i = 0; i < 32; ++i) {
+        if (hash[i] == 0) {
+            bits += 8;
+            continue;
+        }
+        bits += __builtin_clz(hash[i]) - 24;
+        break;
+    }
+    return bits;
+}
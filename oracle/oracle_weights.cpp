@@ -0,0 +1,113 @@
+#include "oracle_weights.hpp"
+#include "entropy_batch.hpp"
+#include "entropy_tables.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+const char* const kColumnNames[kColumnCount] = {
+    "entropy", "pattern", "sensitivity", "tail_entropy", "target_zeros"
+};
+
+double OracleWeights::score(const FeatureVector& f) const {
+    double s = bias;
+    for (size_t c = 0; c < kColumnCount; ++c) s += w[c] * f[c];
+    return s;
+}
+
+bool OracleWeights::entropyPatternOnly() const {
+    for (size_t c = 0; c < kColumnCount; ++c)
+        if (c != kColEntropy && c != kColPattern && w[c] != 0.0) return false;
+    return true;
+}
+
+double targetZeroBits(uint32_t nBits) {
+    int exponent = static_cast<int>(nBits >> 24);
+    uint32_t mantissa = nBits & 0x007fffff;
+    if (exponent < 3) {
+        mantissa >>= 8 * (3 - exponent);
+        exponent = 3;
+    }
+    if (mantissa == 0) return 0.0;
+
+    int mantissaBits = 0;
+    while (mantissa >> mantissaBits) ++mantissaBits;
+    int targetBits = 8 * (exponent - 3) + mantissaBits;
+    return std::max(0, 256 - targetBits);
+}
+
+void computeFeatureRows(const uint8_t* midstates, const uint8_t* tails, const double* pattern,
+                        size_t n, FeatureVector* out) {
+    parallelFor(n, [&](size_t begin, size_t end) {
+        std::vector<entropy::BlockMetrics> metrics(end - begin);
+        entropy::compute_block_metrics(midstates + begin * entropy::kBlockBytes, end - begin, metrics.data());
+
+        for (size_t i = begin; i < end; ++i) {
+            const uint8_t* tail = tails + i * 16;
+            uint32_t tailOnes = 0;
+            for (size_t b = 0; b < 16; ++b) tailOnes += static_cast<uint32_t>(__builtin_popcount(tail[b]));
+            // Tail bytes 8..11 are nBits, little-endian
+            uint32_t nBits = uint32_t(tail[8]) | (uint32_t(tail[9]) << 8) | (uint32_t(tail[10]) << 16) |
+                             (uint32_t(tail[11]) << 24);
+
+            FeatureVector& f = out[i];
+            f[kColEntropy] = metrics[i - begin].entropy;
+            f[kColPattern] = pattern[i];
+            f[kColSensitivity] = metrics[i - begin].sensitivity;
+            f[kColTailEntropy] = entropy::kBitEntropy<128>[tailOnes];
+            f[kColTargetZeros] = targetZeroBits(nBits);
+        }
+    });
+}
+
+bool loadWeights(const std::string& path, OracleWeights& weights) {
+    std::ifstream in(path);
+    if (!in) return true;  // keep defaults
+
+    try {
+        json j;
+        in >> j;
+        OracleWeights loaded;
+        loaded.bias = j.value("bias", 0.0);
+        loaded.fitMaxHeight = j.value("fit_max_height", int64_t(-1));
+        loaded.w.fill(0.0);
+        for (const auto& [name, value] : j.at("weights").items()) {
+            size_t c = 0;
+            while (c < kColumnCount && name != kColumnNames[c]) ++c;
+            if (c == kColumnCount) {
+                std::cerr << "[ERROR] Unknown feature column in " << path << ": " << name << std::endl;
+                return false;
+            }
+            loaded.w[c] = value.get<double>();
+        }
+        weights = loaded;
+        return true;
+    } catch (const json::exception& e) {
+        std::cerr << "[ERROR] Malformed weights file " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool saveWeights(const std::string& path, const OracleWeights& weights,
+                 const std::string& label, uint64_t rows, double r2) {
+    json w = json::object();
+    for (size_t c = 0; c < kColumnCount; ++c) w[kColumnNames[c]] = weights.w[c];
+
+    json j = {
+        {"bias", weights.bias},
+        {"weights", w},
+        {"label", label},
+        {"rows", rows},
+        {"r2", r2}
+    };
+    if (weights.fitMaxHeight >= 0) j["fit_max_height"] = weights.fitMaxHeight;
+    std::ofstream out(path);
+    out << j.dump(2);
+    return static_cast<bool>(out);
+}
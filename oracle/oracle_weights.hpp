@@ -0,0 +1,50 @@
+// oracle_weights.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Linear oracle score over per-midstate feature columns. The default weights
+// are the original 0.6 * entropy + 0.4 * pattern score; fit_weights writes
+// fitted ones to oracle/oracle_weights.json.
+
+enum FeatureColumn : size_t {
+    kColEntropy,      // bit entropy of the midstate
+    kColPattern,      // first-byte histogram count / max count
+    kColSensitivity,  // bit-flip sensitivity of the midstate
+    kColTailEntropy,  // bit entropy of the 16 tail bytes
+    kColTargetZeros,  // leading zero bits of the target encoded by nBits in the tail
+    kColumnCount
+};
+
+extern const char* const kColumnNames[kColumnCount];
+
+using FeatureVector = std::array<double, kColumnCount>;
+
+struct OracleWeights {
+    double bias = 0.0;
+    FeatureVector w{0.6, 0.4};
+    int64_t fitMaxHeight = -1;  // newest block height fit_weights trained on; -1 if not recorded
+
+    // bias + w . f, summed in column order
+    double score(const FeatureVector& f) const;
+
+    // True if only entropy and pattern carry weight besides the bias (what rankTop can rank by)
+    bool entropyPatternOnly() const;
+};
+
+// Leading zero bits of the 256-bit target for compact nBits; 0 for an empty mantissa
+double targetZeroBits(uint32_t nBits);
+
+// Feature rows for n midstates (32 bytes each) and their tails (16 bytes
+// each). Pattern scores come from the caller's histogram. Runs across threads.
+void computeFeatureRows(const uint8_t* midstates, const uint8_t* tails, const double* pattern,
+                        size_t n, FeatureVector* out);
+
+// Loads weights; a missing file keeps the defaults. Returns false on a malformed file.
+bool loadWeights(const std::string& path, OracleWeights& weights);
+
+// Writes weights plus fit metadata (label name, row count, R^2, fitMaxHeight)
+bool saveWeights(const std::string& path, const OracleWeights& weights,
+                 const std::string& label, uint64_t rows, double r2);
@@ -0,0 +1,32 @@
+// parallel.hpp
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of worker threads used by oracle batch jobs
+inline unsigned workerCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Split [0, count) into contiguous chunks and run fn(begin, end) on each chunk
+// in its own thread. Small inputs run inline on the calling thread.
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn, size_t minChunk = 1024) {
+    if (count == 0) return;
+    size_t threads = std::min<size_t>(workerCount(), (count + minChunk - 1) / minChunk);
+    if (threads <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+
+    size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::thread> pool;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t end = std::min(count, begin + chunk);
+        pool.emplace_back([&fn, begin, end] { fn(begin, end); });
+    }
+    for (auto& t : pool) t.join();
+}
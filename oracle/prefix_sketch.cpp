@@ -0,0 +1,148 @@
+#include "prefix_sketch.hpp"
+#include "oracle_store.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+constexpr size_t kMinWidth = 64;
+
+// Prefix keys are short and not uniform in their high bits, so they are
+// mixed (murmur3 finalizer) before picking counters
+inline uint64_t mix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+} // namespace
+
+CountMinSketch::CountMinSketch(size_t memoryBytes, unsigned depth, bool conservative)
+    : rows(std::max(1u, depth)), conservativeUpdate(conservative) {
+    size_t width = kMinWidth;
+    while (width * 2 * rows * sizeof(uint64_t) <= memoryBytes) width *= 2;
+    counters.assign(width * rows, 0);
+    mask = width - 1;
+}
+
+// Row i probes h1 + i * h2 (double hashing)
+uint64_t CountMinSketch::add(uint64_t key, uint64_t count) {
+    uint64_t h1 = mix64(key);
+    uint64_t h2 = mix64(h1) | 1;
+    sum += count;
+
+    uint64_t best = UINT64_MAX;
+    for (unsigned i = 0; i < rows; ++i) best = std::min(best, counters[i * width() + ((h1 + i * h2) & mask)]);
+    uint64_t target = best + count;
+    for (unsigned i = 0; i < rows; ++i) {
+        uint64_t& c = counters[i * width() + ((h1 + i * h2) & mask)];
+        c = conservativeUpdate ? std::max(c, target) : c + count;
+    }
+    return target;
+}
+
+uint64_t CountMinSketch::estimate(uint64_t key) const {
+    uint64_t h1 = mix64(key);
+    uint64_t h2 = mix64(h1) | 1;
+    uint64_t best = UINT64_MAX;
+    for (unsigned i = 0; i < rows; ++i) best = std::min(best, counters[i * width() + ((h1 + i * h2) & mask)]);
+    return rows ? best : 0;
+}
+
+bool CountMinSketch::merge(const CountMinSketch& other) {
+    if (other.rows != rows || other.mask != mask) return false;
+    for (size_t i = 0; i < counters.size(); ++i) counters[i] += other.counters[i];
+    sum += other.sum;
+    return true;
+}
+
+uint64_t CountMinSketch::errorBound() const {
+    return static_cast<uint64_t>(std::ceil(std::exp(1.0) * static_cast<double>(sum) / width()));
+}
+
+PrefixSketch::PrefixSketch(size_t prefixBytes, size_t memoryBytes, unsigned depth)
+    : counts(memoryBytes, depth), bytes(std::clamp<size_t>(prefixBytes, 1, 8)) {}
+
+// First `bytes` midstate bytes, big-endian
+uint64_t PrefixSketch::keyOf(const uint8_t* midstate) const {
+    uint64_t key = 0;
+    for (size_t i = 0; i < bytes; ++i) key = (key << 8) | midstate[i];
+    return key;
+}
+
+void PrefixSketch::add(const uint8_t* midstate) {
+    uint64_t key = keyOf(midstate);
+    uint64_t c = counts.add(key);
+    if (c > heavyCount) {
+        heavyKey = key;
+        heavyCount = c;
+    }
+}
+
+bool PrefixSketch::merge(const PrefixSketch& other) {
+    if (other.bytes != bytes || !counts.merge(other.counts)) return false;
+    // Both halves' heaviest keys, re-estimated: a lower bound until rescanMax()
+    const bool mineSeen = heavyCount > 0, theirsSeen = other.heavyCount > 0;
+    const uint64_t theirKey = other.heavyKey;
+    heavyCount = 0;
+    if (mineSeen) heavyCount = counts.estimate(heavyKey);
+    if (theirsSeen && counts.estimate(theirKey) > heavyCount) {
+        heavyKey = theirKey;
+        heavyCount = counts.estimate(theirKey);
+    }
+    return true;
+}
+
+void PrefixSketch::rescanMax(const uint8_t* midstate) {
+    uint64_t key = keyOf(midstate);
+    uint64_t c = counts.estimate(key);
+    if (c > heavyCount) {
+        heavyKey = key;
+        heavyCount = c;
+    }
+}
+
+uint64_t PrefixSketch::count(const uint8_t* midstate) const {
+    return counts.estimate(keyOf(midstate));
+}
+
+double PrefixSketch::score(const uint8_t* midstate) const {
+    if (heavyCount == 0) return 0.0;
+    return static_cast<double>(count(midstate)) / heavyCount;
+}
+
+PrefixSketch sketchStorePrefixes(const StoreRecord* rows, size_t n, bool includeSynthetic,
+                                 size_t prefixBytes, size_t memoryBytes, unsigned depth) {
+    PrefixSketch total(prefixBytes, memoryBytes, depth);
+    std::mutex totalMutex;
+    parallelFor(n, [&](size_t begin, size_t end) {
+        PrefixSketch local(prefixBytes, memoryBytes, depth);
+        for (size_t i = begin; i < end; ++i)
+            if (includeSynthetic || !(rows[i].flags & kStoreSynthetic)) local.add(rows[i].midstate);
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total.merge(local);
+    }, 1 << 16);
+
+    // The merged maximum can belong to a key no thread saw as its heaviest.
+    // Counters are read-only from here; only the maximum is updated, under the lock.
+    parallelFor(n, [&](size_t begin, size_t end) {
+        const uint8_t* heaviest = nullptr;
+        uint64_t best = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (!includeSynthetic && (rows[i].flags & kStoreSynthetic)) continue;
+            uint64_t c = total.count(rows[i].midstate);
+            if (c > best) {
+                best = c;
+                heaviest = rows[i].midstate;
+            }
+        }
+        std::lock_guard<std::mutex> lock(totalMutex);
+        if (heaviest) total.rescanMax(heaviest);
+    }, 1 << 16);
+    return total;
+}
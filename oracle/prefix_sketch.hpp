@@ -0,0 +1,87 @@
+// prefix_sketch.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct StoreRecord;
+
+// Count-min sketch over 64-bit keys: depth rows of width counters, each key
+// adding to one counter per row and reading back the row minimum. Estimates
+// never undercount; with total count N they overcount by at most e * N / width
+// with probability 1 - e^-depth. Conservative update only raises counters up
+// to the new minimum, which tightens estimates for skewed streams and keeps
+// the same bound. Sketches of equal shape merge by adding counters, so each
+// thread can count its own chunk.
+class CountMinSketch {
+public:
+    CountMinSketch() = default;
+
+    // Largest power-of-two width that fits depth rows of 64-bit counters in memoryBytes
+    explicit CountMinSketch(size_t memoryBytes, unsigned depth = 4, bool conservative = true);
+
+    // Returns the key's estimate after the update
+    uint64_t add(uint64_t key, uint64_t count = 1);
+    uint64_t estimate(uint64_t key) const;
+
+    // False if the shapes differ
+    bool merge(const CountMinSketch& other);
+
+    size_t width() const { return mask + 1; }
+    unsigned depth() const { return rows; }
+    uint64_t total() const { return sum; }
+    size_t memoryBytes() const { return counters.size() * sizeof(uint64_t); }
+
+    // Overcount bound e * N / width, exceeded with probability e^-depth
+    uint64_t errorBound() const;
+
+private:
+    std::vector<uint64_t> counters;  // row-major, rows x width
+    size_t mask = 0;
+    unsigned rows = 0;
+    bool conservativeUpdate = true;
+    uint64_t sum = 0;
+};
+
+// Approximate counts of the first prefixBytes (1..8) bytes of midstates:
+// the sketched counterpart of MidstateHistogram for streams too long, or
+// prefixes too wide, for an exact table. Scores normalize by the largest
+// estimate of any counted prefix, like scoreByHistogram(). add() and
+// merge() only track a lower bound of it: a later add can raise an earlier
+// key's estimate through shared counters, and a key that was never the
+// heaviest in either half of a merge can be the heaviest in the sum.
+// Passing every counted midstate to rescanMax() once counting is done makes
+// maxCount() exact.
+class PrefixSketch {
+public:
+    PrefixSketch(size_t prefixBytes, size_t memoryBytes, unsigned depth = 4);
+
+    void add(const uint8_t* midstate);
+    bool merge(const PrefixSketch& other);
+
+    // Raises maxCount() to this midstate's current estimate
+    void rescanMax(const uint8_t* midstate);
+
+    uint64_t count(const uint8_t* midstate) const;
+    uint64_t maxCount() const { return heavyCount; }
+
+    // count / maxCount: in [0, 1] for counted midstates after a rescan
+    double score(const uint8_t* midstate) const;
+
+    size_t prefixBytes() const { return bytes; }
+    const CountMinSketch& sketch() const { return counts; }
+
+private:
+    uint64_t keyOf(const uint8_t* midstate) const;
+
+    CountMinSketch counts;
+    size_t bytes;
+    uint64_t heavyKey = 0;
+    uint64_t heavyCount = 0;
+};
+
+// Sketches the midstate prefixes of store rows across threads, one sketch
+// per thread merged at the end, then rescans the rows for the exact
+// maxCount(). Synthetic rows are skipped unless includeSynthetic.
+PrefixSketch sketchStorePrefixes(const StoreRecord* rows, size_t n, bool includeSynthetic,
+                                 size_t prefixBytes, size_t memoryBytes, unsigned depth = 4);
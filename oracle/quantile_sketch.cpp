@@ -0,0 +1,201 @@
+#include "quantile_sketch.hpp"
+#include "oracle_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Smallest level capacity, as in the DataSketches KLL (m = 8)
+constexpr size_t kMinCapacity = 8;
+constexpr double kLevelShrink = 2.0 / 3.0;
+
+} // namespace
+
+KllSketch::KllSketch(size_t k, uint64_t seed)
+    : capacityTop(std::max<size_t>(k, kMinCapacity)), rng(seed) {
+    growLevels();
+}
+
+// Level `level` of a sketch whose top is items.size() - 1
+size_t KllSketch::capacity(size_t level) const {
+    return capacities[items.size() - 1 - level];
+}
+
+void KllSketch::growLevels() {
+    items.emplace_back();
+    while (capacities.size() < items.size())
+        capacities.push_back(std::max(kMinCapacity, static_cast<size_t>(std::ceil(
+            capacityTop * std::pow(kLevelShrink, static_cast<double>(capacities.size()))))));
+    totalCapacity = 0;
+    for (size_t h = 0; h < items.size(); ++h) totalCapacity += capacity(h);
+}
+
+void KllSketch::add(double value) {
+    if (std::isnan(value)) return;  // no rank; it would break the sorted levels
+    if (n == 0) lo = hi = value;
+    lo = std::min(lo, value);
+    hi = std::max(hi, value);
+    ++n;
+    items[0].push_back(value);
+    if (++held >= totalCapacity) compress();
+}
+
+// Lazy compaction: while the sketch holds as many items as all levels
+// together may, compact the lowest level that is at or over capacity
+void KllSketch::compress() {
+    while (held >= totalCapacity) {
+        size_t h = 0;
+        while (h + 1 < items.size() && items[h].size() < capacity(h)) ++h;
+        if (h + 1 == items.size()) growLevels();
+
+        std::vector<double>& level = items[h];
+        std::sort(level.begin(), level.end());
+        // An odd item out stays behind; the rest pair up and one of each pair moves up
+        size_t keep = level.size() % 2;
+        size_t offset = splitmix64(rng) & 1;
+        std::vector<double>& up = items[h + 1];
+        for (size_t i = keep + offset; i < level.size(); i += 2) up.push_back(level[i]);
+        held -= (level.size() - keep) / 2;
+        level.resize(keep);
+    }
+}
+
+void KllSketch::merge(const KllSketch& other) {
+    if (other.n == 0) return;
+    if (n == 0) {
+        lo = other.lo;
+        hi = other.hi;
+    }
+    lo = std::min(lo, other.lo);
+    hi = std::max(hi, other.hi);
+    n += other.n;
+    while (items.size() < other.items.size()) growLevels();
+    for (size_t h = 0; h < other.items.size(); ++h)
+        items[h].insert(items[h].end(), other.items[h].begin(), other.items[h].end());
+    held += other.held;
+    compress();
+}
+
+std::vector<std::pair<double, uint64_t>> KllSketch::weighted() const {
+    std::vector<std::pair<double, uint64_t>> all;
+    all.reserve(held);
+    for (size_t h = 0; h < items.size(); ++h)
+        for (double v : items[h]) all.push_back({v, uint64_t(1) << h});
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+std::vector<double> KllSketch::quantiles(const std::vector<double>& qs) const {
+    std::vector<double> out(qs.size(), 0.0);
+    if (n == 0) return out;
+    auto all = weighted();
+    uint64_t weight = 0;
+    for (const auto& item : all) weight += item.second;
+
+    for (size_t i = 0; i < qs.size(); ++i) {
+        double q = std::clamp(qs[i], 0.0, 1.0);
+        if (q <= 0.0) {
+            out[i] = lo;
+            continue;
+        }
+        if (q >= 1.0) {
+            out[i] = hi;
+            continue;
+        }
+        // First item whose cumulative weight reaches q of the total
+        double target = q * weight;
+        uint64_t cum = 0;
+        out[i] = hi;
+        for (const auto& item : all) {
+            cum += item.second;
+            if (cum >= target) {
+                out[i] = item.first;
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+double KllSketch::quantile(double q) const {
+    return quantiles({q})[0];
+}
+
+double KllSketch::rank(double value) const {
+    if (n == 0) return 0.0;
+    uint64_t below = 0, weight = 0;
+    for (size_t h = 0; h < items.size(); ++h) {
+        for (double v : items[h]) {
+            weight += uint64_t(1) << h;
+            if (v <= value) below += uint64_t(1) << h;
+        }
+    }
+    return static_cast<double>(below) / weight;
+}
+
+double KllSketch::normalizedRankError() const {
+    // Empirical fit for KLL sketches (Apache DataSketches), 99% confidence
+    return 2.446 / std::pow(static_cast<double>(capacityTop), 0.9433);
+}
+
+KllSketch KllSketch::fromLevels(size_t k, std::vector<std::vector<double>> levels, double minValue, double maxValue) {
+    KllSketch s(k);
+    if (levels.empty()) return s;
+    while (s.items.size() < levels.size()) s.growLevels();
+    s.items = std::move(levels);
+    for (size_t h = 0; h < s.items.size(); ++h) {
+        s.n += s.items[h].size() << h;
+        s.held += s.items[h].size();
+    }
+    s.lo = minValue;
+    s.hi = maxValue;
+    s.compress();
+    return s;
+}
+
+const std::vector<double> kSummaryQuantiles = {0.0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0};
+
+bool saveQuantileSummary(const std::string& path, const KllSketch& sketch) {
+    json quantiles = json::object();
+    std::vector<double> values = sketch.quantiles(kSummaryQuantiles);
+    for (size_t i = 0; i < values.size(); ++i) {
+        char key[16];
+        std::snprintf(key, sizeof(key), "%g", kSummaryQuantiles[i]);
+        quantiles[key] = values[i];
+    }
+
+    json j = {
+        {"count", sketch.count()},
+        {"min", sketch.minValue()},
+        {"max", sketch.maxValue()},
+        {"rank_error", sketch.normalizedRankError()},
+        {"quantiles", quantiles},
+        {"sketch", {{"k", sketch.k()}, {"levels", sketch.levels()}}}
+    };
+    std::ofstream out(path);
+    out << j.dump(2);
+    return static_cast<bool>(out);
+}
+
+bool loadQuantileSummary(const std::string& path, KllSketch& sketch) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    try {
+        json j;
+        in >> j;
+        const json& s = j.at("sketch");
+        sketch = KllSketch::fromLevels(s.at("k").get<size_t>(), s.at("levels").get<std::vector<std::vector<double>>>(),
+                                       j.at("min").get<double>(), j.at("max").get<double>());
+        return true;
+    } catch (const json::exception& e) {
+        std::cerr << "[ERROR] Malformed quantile summary " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,69 @@
+// quantile_sketch.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// KLL quantile sketch over doubles. Items sit in levels; an item at level h
+// stands for 2^h inputs. Level capacities are k at the top, shrinking by 2/3
+// per level below, at least 8. Once the sketch holds its total capacity, the
+// lowest full level is sorted and every other item, from a coin-flipped
+// offset, moves up a level. Memory is O(k) and
+// quantile queries are within about normalizedRankError() of the true rank.
+// Sketches merge level by level, so threads and shards can each keep one.
+class KllSketch {
+public:
+    explicit KllSketch(size_t k = 200, uint64_t seed = 1);
+
+    // NaN is ignored
+    void add(double value);
+    void merge(const KllSketch& other);
+
+    uint64_t count() const { return n; }
+    bool empty() const { return n == 0; }
+    double minValue() const { return lo; }
+    double maxValue() const { return hi; }
+    size_t k() const { return capacityTop; }
+
+    // Value with about q * count() inputs at or below it, q in [0, 1]
+    double quantile(double q) const;
+    std::vector<double> quantiles(const std::vector<double>& qs) const;
+
+    // Fraction of inputs at or below value
+    double rank(double value) const;
+
+    // Rank error at 99% confidence for this k
+    double normalizedRankError() const;
+
+    // Levels for persisting a sketch; item weights are 2^level
+    const std::vector<std::vector<double>>& levels() const { return items; }
+    static KllSketch fromLevels(size_t k, std::vector<std::vector<double>> levels, double minValue, double maxValue);
+
+private:
+    size_t capacity(size_t level) const;
+    void growLevels();
+    void compress();
+
+    // (value, weight) pairs sorted by value
+    std::vector<std::pair<double, uint64_t>> weighted() const;
+
+    size_t capacityTop;
+    uint64_t rng;
+    uint64_t n = 0;
+    size_t held = 0;           // items retained across levels
+    size_t totalCapacity = 0;
+    double lo = 0.0, hi = 0.0;
+    std::vector<std::vector<double>> items;
+    std::vector<size_t> capacities;  // by distance below the top level
+};
+
+// Quantile levels reported in summaries
+extern const std::vector<double> kSummaryQuantiles;
+
+// Writes count, min, max, kSummaryQuantiles and the sketch levels as JSON,
+// so a later run or another shard can load and merge it
+bool saveQuantileSummary(const std::string& path, const KllSketch& sketch);
+
+// Loads the sketch from a summary. Returns false if the file is missing or malformed.
+bool loadQuantileSummary(const std::string& path, KllSketch& sketch);
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include "../hex_codec.hpp"
+#include "midstate_stream.hpp"
+#include "oracle_store.hpp"
+#include "parallel.hpp"
+#include "randomness_tests.hpp"
+#include "oracle_utils.hpp"
+
+using json = nlohmann::json;
+
+// Randomness test battery over the midstate or block hash stream:
+//
+//   randomness_battery [--store oracle/midstates.bin] [--field midstate|blockhash] [--all]
+//                      [--json oracle/top_midstates.json] [--out oracle/randomness.json]
+//
+// Rows are concatenated into one bit stream and run through monobit, block
+// frequency, runs, serial, approximate entropy and byte chi-square tests.
+// --json tests the midstates of a ranked list instead, e.g. the oracle's
+// top picks, to check whether "better" midstates look any less random.
+// Block hashes fail by construction: their leading bits are forced to zero.
+
+constexpr double kAlpha = 0.01;
+
+// Counts rows [0, n) of `stride`-spaced 32-byte rows for which kept(i) holds, across threads
+template <typename Kept>
+StreamCounts countStream(const uint8_t* base, size_t stride, size_t n, Kept kept) {
+    StreamCounts total;
+    auto nextKept = [&](size_t i) {
+        while (i < n && !kept(i)) ++i;
+        return i;
+    };
+    size_t first = nextKept(0);
+    if (first == n) return total;
+
+    std::mutex totalMutex;
+    parallelFor(n, [&](size_t begin, size_t end) {
+        StreamCounts local;
+        for (size_t i = nextKept(begin); i < end;) {
+            size_t runEnd = i;
+            while (runEnd < end && kept(runEnd)) ++runEnd;
+            size_t after = nextKept(runEnd);
+            bool endsStream = after == n;
+            countRows(base + i * stride, stride, runEnd - i, base + (endsStream ? first : after) * stride,
+                      endsStream, local);
+            i = after;
+        }
+        std::lock_guard<std::mutex> lock(totalMutex);
+        total.merge(local);
+    }, 1 << 16);
+    return total;
+}
+
+int main(int argc, char** argv) {
+    std::string storePath = "oracle/midstates.bin";
+    std::string jsonPath;
+    std::string outPath = "oracle/randomness.json";
+    std::string field = "midstate";
+    bool includeSynthetic = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--all") includeSynthetic = true;
+        else if (arg == "--store" && i + 1 < argc) storePath = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--field" && i + 1 < argc) field = argv[++i];
+        else {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (field != "midstate" && field != "blockhash") {
+        std::cerr << "❌ --field must be midstate or blockhash\n";
+        return 1;
+    }
+
+    StreamCounts counts;
+    uint64_t rows = 0;
+    std::string source;
+    double ms = 0.0;
+
+    if (!jsonPath.empty()) {
+        std::ifstream in(jsonPath);
+        if (!in) {
+            std::cerr << "❌ Error: " << jsonPath << " not found.\n";
+            return 1;
+        }
+        std::vector<uint8_t> midstates;
+        std::string error;
+        bool ok = streamMidstates(in, [&](MidstateRecord&& m) {
+            uint8_t bytes[kStreamRowBytes];
+            if (m.midstate.size() != 2 * kStreamRowBytes || !hexDecode(m.midstate, bytes)) return;
+            midstates.insert(midstates.end(), bytes, bytes + kStreamRowBytes);
+        }, &error);
+        if (!ok) {
+            std::cerr << "❌ Error: failed to parse " << jsonPath << ": " << error << "\n";
+            return 1;
+        }
+        field = "midstate";
+        source = jsonPath;
+        rows = midstates.size() / kStreamRowBytes;
+
+        auto start = std::chrono::steady_clock::now();
+        counts = countStream(midstates.data(), kStreamRowBytes, rows, [](size_t) { return true; });
+        ms = msSince(start);
+    } else {
+        MappedStore store;
+        if (!store.open(storePath)) {
+            std::cerr << "❌ Error: cannot map " << storePath << "\n";
+            return 1;
+        }
+        source = storePath;
+        const uint8_t* base = field == "midstate" ? store.data()->midstate : store.data()->blockhash;
+        auto kept = [&](size_t i) { return includeSynthetic || !(store[i].flags & kStoreSynthetic); };
+
+        auto start = std::chrono::steady_clock::now();
+        counts = countStream(base, sizeof(StoreRecord), store.size(), kept);
+        ms = msSince(start);
+        rows = counts.bits / (8 * kStreamRowBytes);
+    }
+
+    if (counts.bits == 0) {
+        std::cerr << "❌ Error: no rows to test in " << source << "\n";
+        return 1;
+    }
+    std::cout << "🎲 " << rows << " " << field << " rows, " << counts.bits << " bits [" << ms << " ms, "
+              << counts.bits / 8.0 / (ms * 1e6) << " GB/s]\n";
+
+    json tests = json::array();
+    size_t failed = 0;
+    for (const TestResult& r : runBattery(counts)) {
+        bool pass = r.pValue >= kAlpha;
+        failed += !pass;
+        std::cout << (pass ? "   ✅ " : "   ⚠️ ") << r.name << ": statistic " << r.statistic << ", p = " << r.pValue << "\n";
+        tests.push_back({{"name", r.name}, {"statistic", r.statistic}, {"p_value", r.pValue}, {"pass", pass}});
+    }
+
+    json report = {
+        {"source", source},
+        {"field", field},
+        {"rows", rows},
+        {"bits", counts.bits},
+        {"alpha", kAlpha},
+        {"tests", tests}
+    };
+    std::ofstream out(outPath);
+    out << report.dump(2);
+    if (!out) {
+        std::cerr << "❌ Error: Could not write to " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "📊 " << failed << " of " << tests.size() << " tests below p = " << kAlpha << "\n";
+    std::cout << "✅ Saved randomness report to " << outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "randomness_tests.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Rows between folding the 32-bit chunk histograms into the 64-bit counts
+constexpr size_t kFlushRows = size_t(1) << 20;
+
+inline uint64_t loadBE64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+} // namespace
+
+void StreamCounts::merge(const StreamCounts& other) {
+    bits += other.bits;
+    ones += other.ones;
+    transitions += other.transitions;
+    blocks += other.blocks;
+    blockDeviation += other.blockDeviation;
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] += other.bytes[i];
+    for (size_t i = 0; i < windows.size(); ++i) windows[i] += other.windows[i];
+}
+
+std::vector<uint64_t> StreamCounts::patterns(size_t m) const {
+    // Window j starts at bit 4j; offsets 0..3 cover every start position once
+    std::vector<uint64_t> nu(size_t(1) << m, 0);
+    const uint32_t mask = (1u << m) - 1;
+    for (uint32_t w = 0; w < windows.size(); ++w) {
+        if (!windows[w]) continue;
+        for (size_t o = 0; o < 4; ++o) nu[(w >> (kWindowBits - o - m)) & mask] += windows[w];
+    }
+    return nu;
+}
+
+void countRows(const uint8_t* rows, size_t stride, size_t n, const uint8_t* next, bool endsStream,
+               StreamCounts& counts) {
+    // 12-bit windows at byte-aligned and odd nibble offsets; the byte
+    // histogram is the marginal of the byte-aligned ones
+    constexpr size_t kWindows = size_t(1) << kWindowBits;
+    std::vector<uint32_t> hist(2 * kWindows, 0);
+    uint32_t* aligned = hist.data();
+    uint32_t* odd = hist.data() + kWindows;
+    uint64_t ones = 0, transitions = 0, deviation = 0;
+
+    auto flush = [&] {
+        for (size_t v = 0; v < kWindows; ++v) {
+            counts.windows[v] += uint64_t(aligned[v]) + odd[v];
+            counts.bytes[v >> 4] += aligned[v];
+        }
+        std::fill(hist.begin(), hist.end(), 0);
+    };
+
+    uint8_t b[kStreamRowBytes + 8];
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && i % kFlushRows == 0) flush();
+
+        // Row bytes plus a lookahead into the following row
+        const uint8_t* after = i + 1 < n ? rows + (i + 1) * stride : next;
+        std::memcpy(b, rows + i * stride, kStreamRowBytes);
+        std::memcpy(b + kStreamRowBytes, after, 8);
+
+        for (size_t k = 0; k < kStreamRowBytes; ++k) {
+            uint32_t v = (uint32_t(b[k]) << 8) | b[k + 1];
+            ++aligned[v >> 4];
+            ++odd[v & 0x0FFF];
+        }
+
+        uint64_t w[5];
+        for (size_t k = 0; k < 5; ++k) w[k] = loadBE64(b + 8 * k);
+        for (size_t k = 0; k < 4; ++k) {
+            ones += static_cast<uint64_t>(std::popcount(w[k]));
+            transitions += static_cast<uint64_t>(std::popcount(w[k] ^ ((w[k] << 1) | (w[k + 1] >> 63))));
+        }
+        for (size_t k = 0; k < 4; k += 2) {
+            int64_t d = 2 * (std::popcount(w[k]) + std::popcount(w[k + 1])) - int64_t(kBlockFrequencyBits);
+            deviation += static_cast<uint64_t>(d * d);
+        }
+    }
+    // The stream's final bit has no successor
+    if (endsStream && n > 0) {
+        uint64_t lastBit = rows[(n - 1) * stride + kStreamRowBytes - 1] & 1;
+        transitions -= lastBit ^ (next[0] >> 7);
+    }
+
+    counts.bits += n * kStreamRowBytes * 8;
+    counts.ones += ones;
+    counts.transitions += transitions;
+    counts.blocks += n * kStreamRowBytes * 8 / kBlockFrequencyBits;
+    counts.blockDeviation += deviation;
+    flush();
+}
+
+double igamc(double a, double x) {
+    if (x <= 0.0) return 1.0;
+    const double eps = 1e-15;
+    double logPrefix = -x + a * std::log(x) - std::lgamma(a);
+
+    if (x < a + 1.0) {
+        // Series for the lower function P(a, x)
+        double term = 1.0 / a, sum = term;
+        for (double n = 1.0; n < 1e7; n += 1.0) {
+            term *= x / (a + n);
+            sum += term;
+            if (term < sum * eps) break;
+        }
+        return std::max(0.0, 1.0 - sum * std::exp(logPrefix));
+    }
+
+    // Continued fraction for Q(a, x), modified Lentz
+    const double tiny = 1e-300;
+    double b = x + 1.0 - a, c = 1.0 / tiny, d = 1.0 / b, h = d;
+    for (double i = 1.0; i < 1e7; i += 1.0) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = b + an / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < eps) break;
+    }
+    return std::exp(logPrefix) * h;
+}
+
+std::vector<TestResult> runBattery(const StreamCounts& counts, size_t serialBits, size_t apenBits) {
+    std::vector<TestResult> results;
+    const double n = static_cast<double>(counts.bits);
+    if (counts.bits == 0) return results;
+
+    // Monobit
+    double s = std::fabs(2.0 * counts.ones - n) / std::sqrt(n);
+    results.push_back({"monobit", s, std::erfc(s / std::sqrt(2.0))});
+
+    // Block frequency: chi2 = 4M sum (pi_i - 1/2)^2
+    if (counts.blocks > 0) {
+        double chi2 = counts.blockDeviation / static_cast<double>(kBlockFrequencyBits);
+        results.push_back({"block_frequency", chi2, igamc(counts.blocks / 2.0, chi2 / 2.0)});
+    }
+
+    // Runs, with the frequency prerequisite
+    double pi = counts.ones / n;
+    double runs = counts.transitions + 1.0;
+    double runsP = 0.0;
+    if (std::fabs(pi - 0.5) < 2.0 / std::sqrt(n))
+        runsP = std::erfc(std::fabs(runs - 2.0 * n * pi * (1.0 - pi)) / (2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi)));
+    results.push_back({"runs", runs, runsP});
+
+    // Serial: psi^2 over m, m-1 and m-2 bit patterns
+    if (serialBits >= 3 && serialBits <= kMaxPatternBits) {
+        auto psi2 = [&](size_t m) {
+            double sum = 0.0;
+            for (uint64_t v : counts.patterns(m)) sum += static_cast<double>(v) * v;
+            return std::ldexp(sum, static_cast<int>(m)) / n - n;
+        };
+        double p0 = psi2(serialBits), p1 = psi2(serialBits - 1), p2 = psi2(serialBits - 2);
+        double del1 = p0 - p1, del2 = p0 - 2.0 * p1 + p2;
+        results.push_back({"serial_1", del1, igamc(std::ldexp(1.0, static_cast<int>(serialBits) - 2), del1 / 2.0)});
+        results.push_back({"serial_2", del2, igamc(std::ldexp(1.0, static_cast<int>(serialBits) - 3), del2 / 2.0)});
+    }
+
+    // Approximate entropy: phi(m) - phi(m+1)
+    if (apenBits >= 1 && apenBits + 1 <= kMaxPatternBits) {
+        auto phi = [&](size_t m) {
+            double sum = 0.0;
+            for (uint64_t v : counts.patterns(m))
+                if (v) sum += (v / n) * std::log(v / n);
+            return sum;
+        };
+        double apen = phi(apenBits) - phi(apenBits + 1);
+        double chi2 = 2.0 * n * (std::log(2.0) - apen);
+        results.push_back({"approximate_entropy", chi2, igamc(std::ldexp(1.0, static_cast<int>(apenBits) - 1), chi2 / 2.0)});
+    }
+
+    // Byte distribution
+    double bytes = n / 8.0, expected = bytes / 256.0, chi2 = 0.0;
+    for (uint64_t c : counts.bytes) chi2 += (c - expected) * (c - expected) / expected;
+    results.push_back({"byte_chi2", chi2, igamc(255.0 / 2.0, chi2 / 2.0)});
+
+    return results;
+}
@@ -0,0 +1,56 @@
+// randomness_tests.hpp
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// NIST SP 800-22 style tests over a bit stream made of 32-byte rows
+// (midstates or block hashes, concatenated in row order, bits MSB first).
+//
+// One pass gathers additive counts per thread chunk (set bits, bit
+// transitions, 128-bit block frequencies, byte histogram and the histogram
+// of overlapping 12-bit windows at every nibble offset); the tests are then
+// evaluated from the merged counts. Overlapping m-bit pattern counts for the
+// serial and approximate entropy tests are derived from the 12-bit windows,
+// which limits m to 9 but keeps the per-byte work to two L1 increments.
+
+constexpr size_t kStreamRowBytes = 32;
+constexpr size_t kBlockFrequencyBits = 128;
+constexpr size_t kWindowBits = 12;
+constexpr size_t kMaxPatternBits = kWindowBits - 3;
+
+struct StreamCounts {
+    uint64_t bits = 0;
+    uint64_t ones = 0;
+    uint64_t transitions = 0;      // adjacent unequal bits, not wrapping
+    uint64_t blocks = 0;           // complete 128-bit blocks
+    uint64_t blockDeviation = 0;   // sum over blocks of (2 * ones - 128)^2
+    std::array<uint64_t, 256> bytes{};
+    std::vector<uint64_t> windows = std::vector<uint64_t>(size_t(1) << kWindowBits, 0);
+
+    void merge(const StreamCounts& other);
+
+    // Cyclic overlapping m-bit pattern counts, m <= kMaxPatternBits
+    std::vector<uint64_t> patterns(size_t m) const;
+};
+
+// Counts n rows `stride` bytes apart. `next` is the row that follows the
+// last one: the next run of the stream, or the first row when this run ends
+// the stream (patterns wrap around, transitions do not).
+void countRows(const uint8_t* rows, size_t stride, size_t n, const uint8_t* next, bool endsStream,
+               StreamCounts& counts);
+
+struct TestResult {
+    std::string name;
+    double statistic;
+    double pValue;
+};
+
+// Monobit, block frequency, runs, serial (two p-values), approximate entropy
+// and byte chi-square over the merged counts
+std::vector<TestResult> runBattery(const StreamCounts& counts, size_t serialBits = 8, size_t apenBits = 8);
+
+// Regularized upper incomplete gamma function Q(a, x)
+double igamc(double a, double x);
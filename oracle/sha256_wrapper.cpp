@@ -1,7 +1,7 @@
 #include "sha256_wrapper.hpp"
 #include <openssl/sha.h>
-#include <sstream>
-#include <iomanip>
+#include "../hex_codec.hpp"
+#include <stdexcept>
 
 std::vector<uint8_t> sha256(const std::vector<uint8_t>& data) {
     std::vector<uint8_t> hash(SHA256_DIGEST_LENGTH);
@@ -13,21 +13,28 @@ std::vector<uint8_t> sha256(const std::vector<uint8_t>& data) {
 }
 
 std::vector<uint32_t> sha256_midstate(const std::vector<uint8_t>& header) {
-    return std::vector<uint32_t>(8, 0);  // Stub
+    if (header.size() != 64)
+        throw std::runtime_error("sha256_midstate expects exactly 64 bytes");
+
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, header.data(), header.size());
+    return std::vector<uint32_t>(ctx.h, ctx.h + 8);  // Raw internal state after one block
 }
 
-// ✅ FIXED implementation
+// Midstate as hex string (8 words, big-endian), not the finalized digest
 std::string compute_sha256_midstate_hex(const uint8_t* data, size_t len) {
+    if (len != 64)
+        throw std::runtime_error("compute_sha256_midstate_hex expects exactly 64 bytes");
+
     SHA256_CTX ctx;
     SHA256_Init(&ctx);
     SHA256_Update(&ctx, data, len);
 
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_Final(hash, &ctx);
-
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; ++i)
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; ++i)
+        for (int b = 0; b < 4; ++b)
+            bytes[4 * i + b] = static_cast<uint8_t>(ctx.h[i] >> (24 - 8 * b));
 
-    return oss.str();
+    return hexEncode(bytes, sizeof(bytes));
 }
@@ -6,8 +6,9 @@
 // Compute full SHA-256 hash
 std::vector<uint8_t> sha256(const std::vector<uint8_t>& data);
 
-// Optional: return midstate (internal state after first 64 rounds)
+// Midstate (internal state after compressing the first 64-byte block)
 std::vector<uint32_t> sha256_midstate(const std::vector<uint8_t>& header);
 
-// ✅ FIXED declaration: accepts raw uint8_t pointer, not std::string
+// Midstate of a 64-byte block as hex (8 words, big-endian). For many headers
+// use computeMidstates() from midstate_batch.hpp instead.
 std::string compute_sha256_midstate_hex(const uint8_t* data, size_t len);
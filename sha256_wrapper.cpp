@@ -1,7 +1,6 @@
 #include "sha256_wrapper.hpp"
 #include <openssl/sha.h>
-#include <sstream>
-#include <iomanip>
+#include "hex_codec.hpp"
 #include <stdexcept>
 
 // Full SHA-256 hash
@@ -39,12 +38,10 @@ std::string compute_sha256_midstate_hex(const uint8_t* data, size_t len) {
     SHA256_Init(&ctx);
     SHA256_Update(&ctx, data, len);
 
-    std::ostringstream oss;
-    for (int i = 0; i < 8; ++i) {
-        uint32_t h = ctx.h[i];
-        for (int b = 3; b >= 0; --b)
-            oss << std::hex << std::setw(2) << std::setfill('0') << ((h >> (b * 8)) & 0xff);
-    }
+    uint8_t bytes[32];
+    for (int i = 0; i < 8; ++i)
+        for (int b = 0; b < 4; ++b)
+            bytes[4 * i + b] = static_cast<uint8_t>(ctx.h[i] >> (24 - 8 * b));
 
-    return oss.str();
+    return hexEncode(bytes, sizeof(bytes));
 }
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "hex_codec.hpp"
+#include "oracle/oracle_utils.hpp"
+
+// Checks hex_codec's vector paths (AVX2 or SSE2 on x86, NEON on arm64,
+// whichever this build targets) against a plain lookup-table codec. Lengths
+// run past two 32-character vector steps so every body/tail split is covered.
+
+int nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string referenceEncode(const std::vector<uint8_t>& data) {
+    static const char digits[] = "0123456789abcdef";
+    std::string s;
+    for (uint8_t b : data) {
+        s += digits[b >> 4];
+        s += digits[b & 0x0F];
+    }
+    return s;
+}
+
+int main() {
+    // Characters next to the hex ranges, plus bytes the vector compares see as signed
+    const char invalid[] = {'/', ':', '@', 'G', '`', 'g', ' ', '\0', char(0x80), char(0xC1), char(0xFF)};
+    uint64_t seed = 32;
+    size_t checked = 0;
+
+    for (size_t n = 0; n <= 80; ++n) {
+        std::vector<uint8_t> data(n);
+        for (uint8_t& b : data) b = static_cast<uint8_t>(splitmix64(seed));
+
+        std::string expected = referenceEncode(data);
+        std::string encoded = hexEncode(data.data(), n);
+        if (encoded != expected) {
+            std::cerr << "❌ hexEncode differs from the reference at length " << n << "\n";
+            return 1;
+        }
+
+        // Mixed case decodes to the same bytes
+        std::string mixed = expected;
+        for (char& c : mixed)
+            if (c >= 'a' && (splitmix64(seed) & 1)) c = static_cast<char>(c - 'a' + 'A');
+        std::vector<uint8_t> decoded(n);
+        if (!hexDecode(mixed, decoded.data()) || decoded != data) {
+            std::cerr << "❌ hexDecode differs from the reference at length " << n << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < mixed.size(); ++i) {
+            if (nibble(mixed[i]) != (i % 2 ? data[i / 2] & 0x0F : data[i / 2] >> 4)) {
+                std::cerr << "❌ Reference codec disagrees with itself at length " << n << "\n";
+                return 1;
+            }
+        }
+
+        // A single bad character anywhere is rejected
+        for (size_t i = 0; i < mixed.size(); ++i) {
+            for (char c : invalid) {
+                std::string bad = mixed;
+                bad[i] = c;
+                if (hexDecode(bad, decoded.data())) {
+                    std::cerr << "❌ hexDecode accepted character " << int(uint8_t(c)) << " at " << i
+                              << " of length " << n << "\n";
+                    return 1;
+                }
+                ++checked;
+            }
+        }
+        if (!mixed.empty() && hexDecode(mixed.substr(1), decoded.data())) {
+            std::cerr << "❌ hexDecode accepted odd length " << mixed.size() - 1 << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "✅ hex_codec matches the reference codec (" << checked << " invalid inputs rejected)\n";
+    return 0;
+}
@@ -1,39 +1,28 @@
 #include "utils.hpp"
+#include "hex_codec.hpp"
 #include <sstream>
-#include <iomanip>
 #include <openssl/sha.h>
 #include <stdexcept>
-#include <cctype>
 
 std::vector<uint8_t> hexToBytes(const std::string& hex) {
-    std::vector<uint8_t> bytes;
     if (hex.length() % 2 != 0) {
         throw std::invalid_argument("hex string must have even length");
     }
-    bytes.reserve(hex.length() / 2);
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        char high = hex[i];
-        char low = hex[i + 1];
-        if (!std::isxdigit(high) || !std::isxdigit(low)) {
-            throw std::invalid_argument("hex string contains non-hex characters");
-        }
-        uint8_t byte = static_cast<uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16));
-        bytes.push_back(byte);
+    std::vector<uint8_t> bytes(hex.length() / 2);
+    if (!hexDecode(hex, bytes.data())) {
+        throw std::invalid_argument("hex string contains non-hex characters");
     }
     return bytes;
 }
 
 std::string bytesToHex(const std::vector<uint8_t>& bytes) {
-    std::ostringstream oss;
-    for (uint8_t b : bytes)
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
-    return oss.str();
+    return hexEncode(bytes.data(), bytes.size());
 }
 
 std::string toHex(uint32_t value) {
-    std::ostringstream oss;
-    oss << std::hex << std::setw(8) << std::setfill('0') << value;
-    return oss.str();
+    const uint8_t be[4] = {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                           static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    return hexEncode(be, sizeof(be));
 }
 
 std::vector<uint8_t> doubleSHA256(const std::vector<uint8_t>& input) {